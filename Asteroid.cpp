@@ -1,31 +1,37 @@
 #include "Asteroid.h"
 #include <cmath>
+#include "Fixed.h"
 
 Asteroid::Asteroid(double x, double y, double vx, double vy, int size_) {
     pos.x = x; 
     pos.y = y; 
+    prev = pos;
     vel.x = vx; 
     vel.y = vy; 
     size = size_;
 }
 
-void Asteroid::update(double dt, int maxx, int maxy) {
+void Asteroid::update(double dt, int worldW, int worldH) {
+    prev = pos;
+#ifdef FIXED_POINT_PHYSICS
+    fixedStep(pos, vel, dt, worldW, worldH);
+#else
     pos.x += vel.x * dt;
     pos.y += vel.y * dt;
     
-    pos.x = fmod(pos.x, (double)maxx);
-    if (pos.x < 0) pos.x += (double)maxx;
-    
-    double y_min = 1.0;
-    double y_range = (double)(maxy - 1);
-    pos.y = y_min + fmod(pos.y - y_min, y_range);
-    if (pos.y < y_min) pos.y += y_range;
+    wrapPosition(pos, worldW, worldH);
+#endif
 }
 
-char Asteroid::glyph() const { 
-    return (size >= 2) ? 'O' : 'o'; 
+const Sprite& Asteroid::sprite() const { 
+    return ASTEROID_SPRITES[(size >= 3) ? 3 : ((size == 2) ? 2 : 1)]; 
 }
 
 double Asteroid::radius() const { 
-    return (size >= 2) ? 1.8 : 0.9; 
+    if (size >= 3) return 4.6;
+    return (size == 2) ? 2.6 : 0.9; 
+}
+
+PackedBody Asteroid::pack() const {
+    return packBody(pos, vel, BODY_ASTEROID, size, 0);
 }
\ No newline at end of file
@@ -2,16 +2,20 @@
 #define ASTEROID_H
 
 #include "Ship.h"
+#include "Fixed.h"
+#include "Sprite.h"
 
 struct Asteroid {
     Vec2 pos;
+    Vec2 prev; // posicion del tick anterior (para interpolar al dibujar)
     Vec2 vel;
-    int size; // 2 = grande, 1 = pequeño
+    int size; // 3 = grande, 2 = mediano, 1 = pequeño
     
     Asteroid(double x, double y, double vx, double vy, int size_);
-    void update(double dt, int maxx, int maxy);
-    char glyph() const;
-    double radius() const;
+    void update(double dt, int worldW, int worldH);
+    const Sprite& sprite() const;
+    double radius() const; // circulo que envuelve al sprite (broad-phase)
+    PackedBody pack() const; // registro compacto de 16 bytes
 };
 
 #endif
\ No newline at end of file
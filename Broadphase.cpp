@@ -0,0 +1,69 @@
+#include "Broadphase.h"
+#include <algorithm>
+#include <cmath>
+
+void SweepAndPrune::findPairs(const std::vector<Asteroid>& ents, std::vector<std::pair<int,int>>& pairs) {
+    pairs.clear();
+    int n = (int)ents.size();
+
+    if ((int)axis.size() != n) {
+        // cambio la cantidad (splits, nueva oleada): los indices ya no corresponden, reordenar completo
+        axis.resize(n);
+        for (int i = 0; i < n; ++i) axis[i].id = i;
+        for (Entry& e : axis) {
+            double r = ents[e.id].radius();
+            e.minX = ents[e.id].pos.x - r;
+            e.maxX = ents[e.id].pos.x + r;
+        }
+        std::sort(axis.begin(), axis.end(), [](const Entry& a, const Entry& b){ return a.minX < b.minX; });
+    } else {
+        for (Entry& e : axis) {
+            double r = ents[e.id].radius();
+            e.minX = ents[e.id].pos.x - r;
+            e.maxX = ents[e.id].pos.x + r;
+        }
+        // coherencia temporal: insertion sort sobre la lista del tick anterior
+        for (int i = 1; i < n; ++i) {
+            Entry e = axis[i];
+            int j = i - 1;
+            while (j >= 0 && axis[j].minX > e.minX) {
+                axis[j+1] = axis[j];
+                --j;
+            }
+            axis[j+1] = e;
+        }
+    }
+
+    // barrido: solo se comparan los que se solapan en x, y luego se filtra por y
+    for (int i = 0; i < n; ++i) {
+        const Asteroid& a = ents[axis[i].id];
+        double ra = a.radius();
+        for (int j = i + 1; j < n && axis[j].minX <= axis[i].maxX; ++j) {
+            const Asteroid& b = ents[axis[j].id];
+            if (fabs(a.pos.y - b.pos.y) <= ra + b.radius()) {
+                pairs.emplace_back(axis[i].id, axis[j].id);
+            }
+        }
+    }
+}
+
+void SpatialGrid::build(const std::vector<Asteroid>& ents, int worldW, int worldH) {
+    cols = std::max(1, (int)ceil(worldW / CELL_W));
+    rows = std::max(1, (int)ceil(worldH / CELL_H));
+    int n = (int)ents.size();
+
+    // counting sort por celda: dos pasadas lineales, sin asignaciones por celda
+    cellStart.assign(cols * rows + 1, 0);
+    cellOf.resize(n);
+    for (int i = 0; i < n; ++i) {
+        int cx = std::min(cols - 1, std::max(0, (int)(ents[i].pos.x / CELL_W)));
+        int cy = std::min(rows - 1, std::max(0, (int)(ents[i].pos.y / CELL_H)));
+        cellOf[i] = cy * cols + cx;
+        cellStart[cellOf[i] + 1]++;
+    }
+    for (int c = 0; c < cols * rows; ++c) cellStart[c+1] += cellStart[c];
+
+    items.resize(n);
+    std::vector<int> fill(cellStart.begin(), cellStart.end() - 1);
+    for (int i = 0; i < n; ++i) items[fill[cellOf[i]]++] = i;
+}
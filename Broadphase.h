@@ -0,0 +1,61 @@
+#ifndef BROADPHASE_H
+#define BROADPHASE_H
+
+#include <vector>
+#include <utility>
+#include <cmath>
+#include "Asteroid.h"
+
+// sort-and-sweep sobre el eje x para asteroide vs asteroide.
+// la lista ordenada se conserva entre ticks: como los asteroides se mueven poco por tick
+// queda casi ordenada y el insertion sort la arregla en ~O(n)
+class SweepAndPrune {
+public:
+    // devuelve los pares (i, j) cuyas cajas se solapan; i, j son indices en ents
+    void findPairs(const std::vector<Asteroid>& ents, std::vector<std::pair<int,int>>& pairs);
+
+private:
+    struct Entry {
+        double minX, maxX;
+        int id;
+    };
+    std::vector<Entry> axis;
+};
+
+// grilla uniforme de asteroides (indices ordenados por celda, estilo CSR).
+// se reconstruye cuando cambian los asteroides y permite visitar solo los de una region,
+// por ejemplo la que muestra la camara
+class SpatialGrid {
+public:
+    static constexpr double CELL_W = 8.0;
+    static constexpr double CELL_H = 4.0;
+
+    void build(const std::vector<Asteroid>& ents, int worldW, int worldH);
+
+    // llama f(indice) por cada asteroide cuyo centro cae en las celdas que tocan el
+    // rectangulo [x0, x1] x [y0, y1]; el rectangulo puede salirse del mundo (se envuelve)
+    template<class F>
+    void query(double x0, double y0, double x1, double y1, F f) const {
+        if (cols == 0 || rows == 0) return;
+        int cx0 = (int)floor(x0 / CELL_W), cx1 = (int)floor(x1 / CELL_W);
+        int cy0 = (int)floor(y0 / CELL_H), cy1 = (int)floor(y1 / CELL_H);
+        // si el rectangulo es mas grande que el mundo no repetir celdas
+        if (cx1 - cx0 >= cols) cx1 = cx0 + cols - 1;
+        if (cy1 - cy0 >= rows) cy1 = cy0 + rows - 1;
+        for (int cy = cy0; cy <= cy1; ++cy) {
+            int row = ((cy % rows) + rows) % rows;
+            for (int cx = cx0; cx <= cx1; ++cx) {
+                int cell = row * cols + ((cx % cols) + cols) % cols;
+                for (int k = cellStart[cell]; k < cellStart[cell+1]; ++k) f(items[k]);
+            }
+        }
+    }
+
+private:
+    int cols = 0, rows = 0;
+    std::vector<int> cellStart; // cols*rows + 1
+    std::vector<int> items;
+    std::vector<int> cellOf;
+};
+
+#endif
@@ -0,0 +1,128 @@
+#ifndef FIXED_H
+#define FIXED_H
+
+#include <cstdint>
+#include <cmath>
+#include "Ship.h"
+
+// integracion en punto fijo 16.16 (opcional).
+// compilando con -DFIXED_POINT_PHYSICS solo el paso de movimiento (pos += vel*dt, envoltura y
+// friccion) se hace con enteros. el resto sigue en double: el empuje (sqrt y division en
+// Ship::thrust) y los choques y particiones de Game.cpp, asi que el resultado no es
+// independiente del compilador ni de -ffast-math; lo que se gana es que la parte que mas se
+// acumula (la posicion) no arrastre error de redondeo entre ticks.
+// las entidades vivas siguen siendo las de siempre (Vec2 en double). las posiciones quedan
+// siempre con valores 16.16 exactos (un double representa cualquier 16.16 sin perdida),
+// asi que pasarlas a entero en cada paso es una multiplicacion exacta, sin redondeo
+
+typedef int32_t fix16;
+
+static const int FIX_SHIFT = 16;
+static const fix16 FIX_ONE = 1 << FIX_SHIFT;
+
+inline fix16 toFix(double v) {
+    return (fix16)lround(v * FIX_ONE);
+}
+
+// para posiciones en modo punto fijo: despues del primer paso ya son 16.16 exactos y esto no
+// redondea nada; antes (posicion inicial cualquiera) trunca, que es igual de determinista
+inline fix16 exactFix(double v) {
+    return (fix16)(v * FIX_ONE);
+}
+
+inline double fromFix(fix16 v) {
+    return (double)v / FIX_ONE;
+}
+
+inline fix16 fixMul(fix16 a, fix16 b) {
+    return (fix16)(((int64_t)a * b) >> FIX_SHIFT);
+}
+
+// envolver con comparaciones (el paso por tick siempre es menor que el mundo)
+inline fix16 wrapFix(fix16 v, fix16 size) {
+    if (v >= size) v -= size;
+    else if (v < 0) v += size;
+    return v;
+}
+
+// velocidades en Q6.10 (celdas por segundo, hasta +-32): caben en 16 bits dentro del
+// registro compacto, asi el estado empaquetado es exactamente el estado simulado
+typedef int16_t vfix;
+static const int VEL_SHIFT = 10;
+
+inline vfix toVel(double v) {
+    long q = lround(v * (1 << VEL_SHIFT));
+    if (q > INT16_MAX) q = INT16_MAX;
+    if (q < INT16_MIN) q = INT16_MIN;
+    return (vfix)q;
+}
+
+inline double fromVel(vfix v) {
+    return (double)v / (1 << VEL_SHIFT);
+}
+
+// un paso de integracion en punto fijo: pos += vel*dt, envuelto a [0, w) x [0, h).
+// la velocidad queda cuantizada a Q6.10; devuelve el desplazamiento (sin envolver)
+inline Vec2 fixedStep(Vec2& pos, Vec2& vel, double dt, int worldW, int worldH) {
+    fix16 fdt = toFix(dt);
+    vfix vx = toVel(vel.x);
+    vfix vy = toVel(vel.y);
+    fix16 dx = fixMul((fix16)vx << (FIX_SHIFT - VEL_SHIFT), fdt);
+    fix16 dy = fixMul((fix16)vy << (FIX_SHIFT - VEL_SHIFT), fdt);
+    pos.x = fromFix(wrapFix(exactFix(pos.x) + dx, worldW << FIX_SHIFT));
+    pos.y = fromFix(wrapFix(exactFix(pos.y) + dy, worldH << FIX_SHIFT));
+    vel.x = fromVel(vx);
+    vel.y = fromVel(vy);
+
+    Vec2 step;
+    step.x = fromFix(dx);
+    step.y = fromFix(dy);
+    return step;
+}
+
+// friccion de 1% por tick; la division entera trunca hacia cero y el minimo de 1
+// garantiza que la nave termine quieta en vez de quedar a la deriva
+inline void fixedFriction(Vec2& vel) {
+    vfix v[2] = { toVel(vel.x), toVel(vel.y) };
+    for (vfix &c : v) {
+        int d = c / 100;
+        if (d == 0 && c != 0) d = (c > 0) ? 1 : -1;
+        c = (vfix)(c - d);
+    }
+    vel.x = fromVel(v[0]);
+    vel.y = fromVel(v[1]);
+}
+
+// registro compacto de una entidad (16 bytes). es solo la forma canonica del estado para el
+// checksum de lockstep (pack() al calcularlo); la simulacion no lo usa
+enum BodyKind : uint8_t { BODY_ASTEROID = 0, BODY_BULLET = 1, BODY_SHIP = 2 };
+
+struct PackedBody {
+    int32_t x, y;    // posicion 16.16
+    int16_t vx, vy;  // velocidad Q6.10
+    uint8_t kind;    // BodyKind
+    uint8_t tag;     // tamaño del asteroide, dueño de la bala, nro de nave
+    int16_t aux;     // vida de la bala, direccion de la nave
+};
+static_assert(sizeof(PackedBody) == 16, "PackedBody debe medir 16 bytes");
+
+inline PackedBody packBody(const Vec2& pos, const Vec2& vel, BodyKind kind, int tag, int aux) {
+    PackedBody b;
+    b.x = toFix(pos.x);
+    b.y = toFix(pos.y);
+    b.vx = toVel(vel.x);
+    b.vy = toVel(vel.y);
+    b.kind = kind;
+    b.tag = (uint8_t)tag;
+    b.aux = (int16_t)aux;
+    return b;
+}
+
+inline void unpackBody(const PackedBody& b, Vec2& pos, Vec2& vel) {
+    pos.x = fromFix(b.x);
+    pos.y = fromFix(b.y);
+    vel.x = fromVel(b.vx);
+    vel.y = fromVel(b.vy);
+}
+
+#endif
@@ -0,0 +1,75 @@
+#include "FrameBudget.h"
+#include <algorithm>
+
+static const double SMOOTH = 0.1;      // peso de la muestra nueva en la media movil
+static const int OVER_PCT = 90;        // por encima: sobrecarga
+static const int UNDER_PCT = 50;       // por debajo: hay margen
+static const int OVER_TICKS = 15;      // ~0.5 s seguidos para degradar
+static const int UNDER_TICKS = 90;     // ~3 s seguidos para restituir
+
+void FrameBudget::reset(int maxLvl, int tickBudgetUs, int frameBudgetUs, int64_t nowNs) {
+    maxLevel = std::max(0, std::min(maxLvl, MAX_LEVEL));
+    tickBudgetNs = tickBudgetUs * 1000.0;
+    frameBudgetNs = frameBudgetUs * 1000.0;
+    lvl = 0;
+    tickPct = framePct = 0;
+    tickAvg = frameAvg = 0.0;
+    over = under = 0;
+    start = lastNs = nowNs;
+    for (int i = 0; i <= MAX_LEVEL; ++i) timeAt[i] = 0;
+    nChanges = 0;
+    peak = 0;
+}
+
+void FrameBudget::frameDone(int64_t costNs) {
+    frameAvg += SMOOTH * (costNs - frameAvg);
+    framePct.store((int)(100.0 * frameAvg / frameBudgetNs), std::memory_order_relaxed);
+}
+
+void FrameBudget::tickDone(int64_t costNs, int64_t nowNs) {
+    tickAvg += SMOOTH * (costNs - tickAvg);
+    int tp = (int)(100.0 * tickAvg / tickBudgetNs);
+    int fp = framePct.load(std::memory_order_relaxed);
+    tickPct.store(tp, std::memory_order_relaxed);
+
+    int cur = lvl.load(std::memory_order_relaxed);
+    timeAt[cur] += nowNs - lastNs;
+    lastNs = nowNs;
+
+    int load = std::max(tp, fp);
+    over = (load > OVER_PCT) ? over + 1 : 0;
+    under = (load < UNDER_PCT) ? under + 1 : 0;
+
+    int next = cur;
+    if (over >= OVER_TICKS && cur < maxLevel) next = cur + 1;
+    else if (under >= UNDER_TICKS && cur > 0) next = cur - 1;
+    if (next == cur) return;
+
+    if (nChanges < MAX_CHANGES) {
+        Change &c = changes[nChanges];
+        c.atNs = nowNs - start;
+        c.from = (uint8_t)cur;
+        c.to = (uint8_t)next;
+        c.tickPct = (uint16_t)std::min(tp, 65535);
+        c.framePct = (uint16_t)std::min(fp, 65535);
+    }
+    nChanges++;
+    peak = std::max(peak, next);
+    over = under = 0;
+    lvl.store(next, std::memory_order_relaxed);
+}
+
+void FrameBudget::report(FILE* f, int64_t nowNs) const {
+    int64_t total = std::max<int64_t>(1, nowNs - start);
+    fprintf(f, "  carga: nivel max %d de %d, %d cambios | tiempo por nivel:", peak, maxLevel, nChanges);
+    for (int i = 0; i <= MAX_LEVEL; ++i) {
+        int64_t t = timeAt[i] + (i == level() ? nowNs - lastNs : 0);
+        fprintf(f, " %d=%.1f%%", i, 100.0 * t / total);
+    }
+    fputc('\n', f);
+    for (int i = 0; i < nChanges && i < MAX_CHANGES; ++i) {
+        const Change &c = changes[i];
+        fprintf(f, "    %7.2fs nivel %d -> %d (sim %d%%, dibujo %d%%)\n",
+                c.atNs / 1e9, c.from, c.to, c.tickPct, c.framePct);
+    }
+}
@@ -0,0 +1,69 @@
+#ifndef FRAMEBUDGET_H
+#define FRAMEBUDGET_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+
+// control de carga: compara lo que tarda cada tick de simulacion y cada cuadro con su
+// presupuesto (el periodo base) y, si se pasa de forma sostenida, degrada de a un nivel:
+//   1: se dibuja a la mitad de frecuencia
+//   2: ademas la simulacion junta dos pasos en uno (mismo tiempo de juego, la mitad de ticks)
+//   3: ademas las oleadas nuevas vienen a la mitad de tamaño
+// cuando vuelve a haber margen se restituye tambien de a un nivel.
+// la carga se mide siempre contra el presupuesto base (no el degradado): asi "hay margen"
+// quiere decir que el nivel anterior entraria, y no oscila.
+// los niveles 2 y 3 cambian la simulacion: en lockstep el tope es 1
+class FrameBudget {
+public:
+    static constexpr int MAX_LEVEL = 3;
+
+    FrameBudget() { reset(0, 1, 1, 0); }
+
+    // con los hilos de la partida detenidos
+    void reset(int maxLevel, int tickBudgetUs, int frameBudgetUs, int64_t nowNs);
+
+    // hilo de simulacion: costo del tick recien hecho; aca se decide el nivel
+    void tickDone(int64_t costNs, int64_t nowNs);
+    // drawThread: costo del cuadro recien dibujado
+    void frameDone(int64_t costNs);
+
+    int level() const { return lvl.load(std::memory_order_relaxed); }
+    int renderDiv() const { return level() >= 1 ? 2 : 1; }
+    int simSteps() const { return level() >= 2 ? 2 : 1; }
+    bool capSpawns() const { return level() >= 3; }
+
+    // carga suavizada, en % del presupuesto base (para el HUD)
+    int tickLoad() const { return tickPct.load(std::memory_order_relaxed); }
+    int frameLoad() const { return framePct.load(std::memory_order_relaxed); }
+
+    void report(FILE* f, int64_t nowNs) const; // con los hilos detenidos
+
+private:
+    static const int MAX_CHANGES = 32; // las que no entran solo se cuentan
+
+    struct Change {
+        int64_t atNs;
+        uint8_t from, to;
+        uint16_t tickPct, framePct;
+    };
+
+    std::atomic<int> lvl;
+    std::atomic<int> tickPct, framePct;
+    int maxLevel;
+    double tickBudgetNs, frameBudgetNs;
+
+    // solo el hilo de simulacion
+    double tickAvg;
+    int over, under; // ticks seguidos con / sin sobrecarga
+    int64_t start, lastNs;
+    int64_t timeAt[MAX_LEVEL + 1];
+    Change changes[MAX_CHANGES];
+    int nChanges;
+    int peak;
+
+    // solo drawThread
+    double frameAvg;
+};
+
+#endif
@@ -1,6 +1,8 @@
 #include "Game.h"
+#include "Trig.h"
 #include <ncurses.h>
 #include <unistd.h>
+#include <sys/stat.h>
 #include <chrono>
 #include <thread>
 #include <cstdlib>
@@ -8,15 +10,61 @@
 #include <algorithm>
 #include <cmath>
 #include <sstream>
-#include <fstream>
 #include <cstring>
 
+// periodos de simulacion (fijos) y de dibujo (independiente, lo mas rapido que aguante la terminal)
+static const int SIM_TICK_US = 33000;
+static const int BULLET_TICK_US = 25000; // periodo original de las balas: fija su avance por tick
+static const int DRAW_INTERVAL_US = 16000;
+// avance de bala por tick de simulacion (0.2 por BULLET_TICK_US, mismo avance por segundo)
+static const double BULLET_STEP = 0.2 * SIM_TICK_US / BULLET_TICK_US;
+// trabajadores del pool del tick (ademas de updateThread, que tambien ejecuta tareas)
+static const int MAX_TICK_WORKERS = 3;
+
+// el mundo mide WORLD_SCALE pantallas por lado; los asteroides a mas de FAR_VIEWS
+// pantallas de toda nave se actualizan solo cada FAR_TICK_DIV ticks (con dt mayor)
+static const int WORLD_SCALE = 3;
+static const double FAR_VIEWS = 1.5;
+static const int FAR_TICK_DIV = 4;
+
+// scripts: cada cuanto llegan refuerzos y cuanto dura un aviso en el HUD (en ticks)
+static const int REINFORCE_TICKS = 30 * 1000000 / SIM_TICK_US;
+static const int BANNER_TICKS = 2 * 1000000 / SIM_TICK_US;
+
+// foto de la partida en curso: si el proceso muere se pierde a lo sumo este intervalo
+static const char* CHECKPOINT_PATH = "savegame.snap";
+static const int64_t CHECKPOINT_INTERVAL_NS = 2000000000LL;
+
+static const char* CONFIG_PATH = "asteroids.conf";
+static const char* SCORES_PATH = "scores";
+static const char* REPORT_LOG_PATH = "debug.log";
+
+// diferencia envuelta al rango [-size/2, size/2)
+static double wrapDelta(double d, double size) {
+    if (d >= size/2) d -= size;
+    else if (d < -size/2) d += size;
+    return d;
+}
+
+static int64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
 Game::Game()
 : player(40, 12), player2(40, 14), quitFlag(false), paused(false), 
-  gameRunning(false), returnToMenu(false), mode(1), winScore(60) {
-    srand(time(nullptr));
+  gameRunning(false), returnToMenu(false), mode(1), winScore(60), scoreWriter(leaderboard),
+  asteroidTick(0), eventLogFile(nullptr), rng((uint64_t)time(nullptr)), lockstep(false), netKeys(0), netKeysNs(0), tickSteps(1) {
+    config.load(CONFIG_PATH);
+    scoresPath = SCORES_PATH;
+    logPath = REPORT_LOG_PATH;
+    checkpointPath = CHECKPOINT_PATH;
+    particles.setCapacity(config.particleBudget);
+    subscribeListeners();
     initscr();
     getmaxyx(stdscr, maxy, maxx);
+    worldW = maxx * WORLD_SCALE;
+    worldH = (maxy - 2) * WORLD_SCALE;
     shutdownNcurses(); 
 }
 
@@ -46,12 +94,58 @@ void Game::shutdownNcurses() {
     endwin();
 }
 
+void Game::setNetwork(NetRole role, const std::string& path) {
+    net.role = role;
+    netPath = path;
+}
+
+void Game::setSpectatorSocket(const std::string& path) {
+    spectatorPath = path;
+}
+
+// el bot juega con puntajes, checkpoint y reportes propios en un directorio temporal: no
+// ensucia los puntajes reales ni pisa (o retoma) la partida guardada del jugador.
+// el directorio queda al salir para poder revisar su debug.log
+bool Game::setSoak(int matches) {
+    char dir[] = "/tmp/asteroids-soak-XXXXXX";
+    if (!mkdtemp(dir)) return false;
+    soakDir = dir;
+    scoresPath = soakDir + "/" + SCORES_PATH;
+    checkpointPath = soakDir + "/" + CHECKPOINT_PATH;
+    logPath = soakDir + "/" + REPORT_LOG_PATH;
+    soak.begin(matches, config.soak);
+    return true;
+}
+
 void Game::run() {
+    // aplica lo que haya quedado en el journal; si falla, saveScoresAfterGame avisa
+    scoreWriter.start(scoresPath);
+    if (!spectatorPath.empty()) spectators.start(spectatorPath);
+    checkpoints.start(checkpointPath);
     initNcurses();
+    if (net.role != NET_NONE) {
+        // en red se juega una sola partida de modo 3 y se sale
+        if (connectPeer()) {
+            mode = 3;
+            winScore = 100;
+            startGame();
+        }
+        net.close();
+        quitFlag = true;
+    }
     while (!quitFlag) {
         mainMenu();
+        // --soak: cada vuelta por el menu es una partida del bot
+        if (soak.active() && !soakAfterMatch()) quitFlag = true;
     }
     shutdownNcurses();
+    if (soak.active()) {
+        fprintf(stderr, "soak: %d partidas, %s%s (detalle en %s)\n", soak.matches(),
+                soak.failed() ? "fuera de presupuesto: " : "OK", soak.breach().c_str(), logPath.c_str());
+    }
+    checkpoints.stop();
+    spectators.stop();
+    scoreWriter.stop();
 }
 
 void Game::mainMenu() {
@@ -63,7 +157,16 @@ void Game::mainMenu() {
         "Puntajes",
         "Salir"
     };
+    // partida interrumpida (Q, cierre o caida): se ofrece retomarla
+    std::string saved;
+    SnapshotHeader savedHdr;
+    std::vector<Asteroid> savedAst;
+    std::vector<Projectile> savedBul;
+    bool canResume = Snapshot::load(checkpointPath, saved) && Snapshot::decode(saved, savedHdr, savedAst, savedBul);
+    if (canResume) options.insert(options.begin(), "Continuar partida");
+    int base = canResume ? 1 : 0;
     int choice = -1;
+    bot.menuShown();
 
     while (choice == -1) {
         getmaxyx(stdscr, maxy, maxx);
@@ -86,7 +189,7 @@ void Game::mainMenu() {
         int ch = ERR;
         {
             std::lock_guard<std::mutex> lock(mtxNcurses);  // protege getch de ncurses 
-            ch = getch();
+            ch = soak.active() ? bot.menuKey(soak.matches(), canResume) : getch();
         }
         if (ch == KEY_UP) highlight = (highlight - 1 + (int)options.size()) % (int)options.size();
         else if (ch == KEY_DOWN) highlight = (highlight + 1) % (int)options.size();
@@ -100,35 +203,113 @@ void Game::mainMenu() {
         refresh();
     }
 
-    if (choice == 0) startGame();
-    else if (choice == 1) showInstructions();
-    else if (choice == 2) showScores();
-    else if (choice == 3) { quitFlag = true; }
+    if (canResume && choice == 0) startGame(true);
+    else if (choice == base + 0) startGame();
+    else if (choice == base + 1) showInstructions();
+    else if (choice == base + 2) showScores();
+    else if (choice == base + 3) { quitFlag = true; }
 }
 
-void Game::startGame() {
+// pantalla de espera hasta que el otro proceso se conecte (Q cancela).
+// el host elige semilla y tamaño del mundo y se los manda al cliente
+bool Game::connectPeer() {
+    bool listening = (net.role == NET_HOST) ? net.listenOn(netPath) : true;
+    bool ok = false;
+    while (listening && !ok) {
+        int ch;
+        {
+            std::lock_guard<std::mutex> lock(mtxNcurses);
+            getmaxyx(stdscr, maxy, maxx);
+            clear();
+            if (net.role == NET_HOST) {
+                mvprintw(maxy/2 - 1, 2, "Esperando al jugador 2 en %s ...", netPath.c_str());
+            } else {
+                mvprintw(maxy/2 - 1, 2, "Conectando con %s ...", netPath.c_str());
+            }
+            mvprintw(maxy/2 + 1, 2, "Q = cancelar");
+            refresh();
+            ch = getch();
+        }
+        if (ch == 'q' || ch == 'Q') break;
+
+        if (net.role == NET_HOST) {
+            if (!net.acceptPeer(200)) continue;
+            worldW = maxx * WORLD_SCALE;
+            worldH = (maxy - 2) * WORLD_SCALE;
+            uint64_t seed = ((uint64_t)time(nullptr) << 20) ^ (uint64_t)getpid();
+            ok = net.sendHello(seed, worldW, worldH);
+        } else {
+            if (!net.tryConnect(netPath)) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(200));
+                continue;
+            }
+            ok = net.recvHello(Lockstep::RECV_TIMEOUT_MS);
+        }
+        if (!ok) net.close();
+        if (!ok && net.role == NET_HOST) break;
+    }
+    if (!ok) net.close();
+    return ok;
+}
+
+void Game::startGame(bool resume) {
     // preparar estado inicial del juego 
-    resetGame();
+    lockstep = (net.role != NET_NONE && net.connected());
+    netKeys = 0;
+    netError.clear();
+    // antes de armar la partida: la primera oleada no tiene que salir con el nivel de la anterior.
+    // en lockstep solo se puede degradar el dibujo: la simulacion tiene que ser igual en los dos
+    budget.reset(config.adaptive ? (lockstep ? 1 : FrameBudget::MAX_LEVEL) : 0,
+                 SIM_TICK_US, DRAW_INTERVAL_US, nowNs());
+    tickSteps = 1;
+    if (!resume || lockstep || !restoreCheckpoint()) resetGame();
     gameRunning = true;
     paused = false;
     returnToMenu = false; // <-- CORRECCIÓN: permitir que los hilos corran
+    asteroidTickNs = bulletTickNs = shipTickNs = nowNs();
+    jitterSim.reset();
+    jitterRender.reset();
+    jitterInput.reset();
+    inputLatency.reset();
+    netKeysNs = 0;
+    stats.reset();
+    particles.clear();
+    tickEvents.clear();
+    if (soak.active()) bot.matchStarted(nowNs(), soak.budget.matchSeconds);
+    if (!config.eventLog.empty()) eventLogFile = fopen(config.eventLog.c_str(), "ab");
+    {
+        std::lock_guard<std::mutex> lock(mtxTuning);
+        tuningErrors.clear();
+    }
 
-    // crear los 10 hilos 
-    pthread_t threads[10];
-    
-    // hilos principales
+    // scripts de la partida: corren dentro del tick, sin hilos propios
+    scripts.spawn(reinforcementScript());
+    scripts.spawn(bannerScript(SEVT_WAVE_CLEARED, "Nueva oleada!"));
+    scripts.spawn(bannerScript(SEVT_SHIP_LOST, "Nave destruida"));
+
+    // la oleada siguiente se va armando desde ya
+    // (en lockstep no: el generador usa su propio azar y las dos simulaciones divergirian)
+    if (!lockstep) {
+        waveGen.start();
+        std::lock_guard<std::mutex> lock(mtxShips);
+        requestNextWave();
+    }
+
+    // la simulacion de cada tick es un grafo de tareas que updateThread reparte en el pool
+    buildTickGraph();
+    int hw = (int)std::thread::hardware_concurrency();
+    int workers = std::max(1, std::min(MAX_TICK_WORKERS, hw - 1));
+    tickPool.start(workers, [this](int i) {
+        char name[16];
+        snprintf(name, sizeof(name), "ast-task%d", i);
+        tuneThread(name, TG_SIM);
+    });
+
+    pthread_t threads[4];
     pthread_create(&threads[0], NULL, inputThread, this);
     pthread_create(&threads[1], NULL, updateThread, this);
-    pthread_create(&threads[2], NULL, collisionThread, this);
-    pthread_create(&threads[3], NULL, drawThread, this);
-    pthread_create(&threads[4], NULL, gameLogicThread, this);
-    
-    // hilos auxiliares
-    pthread_create(&threads[5], NULL, asteroidUpdateThread, this);
-    pthread_create(&threads[6], NULL, projectileUpdateThread, this);
-    pthread_create(&threads[7], NULL, ship1UpdateThread, this);
-    pthread_create(&threads[8], NULL, ship2UpdateThread, this);
-    pthread_create(&threads[9], NULL, hudUpdateThread, this);
+    pthread_create(&threads[2], NULL, drawThread, this);
+    pthread_create(&threads[3], NULL, hudUpdateThread, this);
 
     // ESPERAR A QUE EL JUEGO TERMINE 
     while (gameRunning && !returnToMenu) {
@@ -143,9 +324,32 @@ void Game::startGame() {
     cvUpdate.notify_all();
 
     // Esperar a que todos los hilos terminen (sin pthread_cancel)
-    for (int i = 0; i < 10; i++) {
+    for (int i = 0; i < 4; i++) {
         pthread_join(threads[i], NULL);
     }
+    tickPool.stop();
+    if (config.jitterReport) writeJitterReport();
+    if (config.latencyReport) writeLatencyReport();
+    if (config.statsReport) writeStatsReport();
+    if (eventLogFile) {
+        fclose(eventLogFile);
+        eventLogFile = nullptr;
+    }
+    waveGen.stop();
+    scripts.clear();
+    hudMessage.clear();
+
+    // partida terminada: no hay nada que retomar. si se salio con Q (o de otro modo)
+    // queda la foto del estado final para "Continuar partida"
+    if (!lockstep) {
+        if (matchOver()) {
+            checkpoints.discard();
+        } else {
+            captureCheckpoint(checkpointBuf);
+            checkpoints.submit(checkpointBuf);
+            checkpoints.flush(); // que el menu ya la encuentre
+        }
+    }
 
     // MOSTRAR PANTALLA FINAL Y GUARDAR PUNTAJES
     showEndGameScreen();
@@ -159,51 +363,84 @@ void Game::startGame() {
 
 void Game::resetGame() {
     getmaxyx(stdscr, maxy, maxx);
-    player.reset(maxx/3.0, maxy/2.0);
+    // fila 0 = HUD, ultima fila = controles; el resto es la vista del mundo
+    worldW = maxx * WORLD_SCALE;
+    worldH = (maxy - 2) * WORLD_SCALE;
+    if (lockstep) {
+        // mundo y semilla del host: las dos simulaciones arrancan identicas
+        worldW = net.worldW;
+        worldH = net.worldH;
+        rng.seed(net.seed);
+        asteroidTick = 0;
+    }
+    player.reset(worldW/3.0, worldH/2.0);
     player.lives.store(3);
     player.score.store(0);
-    player2.reset(2*maxx/3.0, maxy/2.0);
+    player2.reset(2*worldW/3.0, worldH/2.0);
     player2.lives.store(3);
     player2.score.store(0);
     bullets.clear();
     asteroids.clear();
     paused = false;
     returnToMenu = false;
+    std::lock_guard<std::mutex> lock(mtxAsteroids);
     spawnInitialAsteroids();
 }
 
-void Game::spawnInitialAsteroids() {
-    std::lock_guard<std::mutex> lock(mtxAsteroids);
+int Game::waveSize() const {
     int count = (mode == 1) ? 10 : 15;
     if (mode == 3) count = 15;
+    if (budget.capSpawns()) count /= 2; // sobrecarga sostenida (nunca en lockstep)
+    return count * WORLD_SCALE;
+}
+
+void Game::requestNextWave() {
+    waveGen.request(waveSize(), worldW, worldH, player.pos, (mode == 3) ? player2.pos : player.pos);
+}
+
+// sin lock propio: lo llaman resetGame y applyEvents, que ya tienen mtxAsteroids
+void Game::spawnInitialAsteroids() {
+    int count = waveSize();
     for (int i=0; i<count; ++i) {
-        double x = rand() % (maxx-8) + 4;
-        double y = (rand() % (maxy-8)) + 2;
+        double x = rng.range(worldW-8) + 4;
+        double y = rng.range(worldH-4) + 2;
         if (fabs(x - player.pos.x) < 8 && fabs(y - player.pos.y) < 4) { x += 10; y += 3; }
         if (fabs(x - player2.pos.x) < 8 && fabs(y - player2.pos.y) < 4) { x -= 10; y -= 3; }
-        double vx = ((rand()%200)/100.0 - 1.0) * 0.8;
-        double vy = ((rand()%200)/100.0 - 1.0) * 0.8;
+        double vx = (rng.range(200)/100.0 - 1.0) * 0.8;
+        double vy = (rng.range(200)/100.0 - 1.0) * 0.8;
         if (fabs(vx) < 0.1) vx = 0.3;
         if (fabs(vy) < 0.1) vy = -0.3;
-        asteroids.emplace_back(x, y, vx, vy, 2);
+        int size = (rng.range(5) == 0) ? 3 : 2; // algunos grandes
+        asteroids.emplace_back(x, y, vx, vy, size);
     }
 }
 
 //============================================================================
-// HILOS PRINCIPALES (5)
+// HILOS DE LA PARTIDA (4 + trabajadores del TaskPool)
 //============================================================================
 
 void* Game::inputThread(void* arg) {
     Game* g = (Game*)arg;
+    g->tuneThread("ast-input", TG_INPUT);
     
     while (g->gameRunning && !g->returnToMenu) { 
+        g->jitterInput.tick(nowNs());
         int ch = ERR;
         {
             std::lock_guard<std::mutex> lock(g->mtxNcurses);  
-            ch = getch();
+            ch = g->soak.active() ? g->bot.gameKey(nowNs(), g->mode == 3) : getch();
         }
         if (ch != ERR) {
-            g->handleInput(ch);
+            int64_t readNs = nowNs();
+            // en lockstep las teclas no se aplican aqui: viajan en el frame del tick
+            if (g->lockstep) {
+                int64_t none = 0;
+                g->netKeysNs.compare_exchange_strong(none, readNs);
+                g->netKeys.fetch_or(g->keyBits(ch));
+            } else {
+                g->handleInput(ch);
+                g->inputLatency.inputApplied(readNs, nowNs());
+            }
         }
         usleep(20000);
     }
@@ -213,208 +450,403 @@ void* Game::inputThread(void* arg) {
 
 void* Game::updateThread(void* arg) {
     Game* g = (Game*)arg;
-    
-    while (g->gameRunning && !g->returnToMenu) {
-        if (!g->paused) {
-            g->cvUpdate.notify_all(); 
-        }
-        usleep(33000);
-    }
-    
-    return NULL;
-}
+    g->tuneThread("ast-update", TG_SIM);
 
-void* Game::collisionThread(void* arg) {
-    Game* g = (Game*)arg;
+    if (g->lockstep) {
+        g->lockstepLoop();
+        return NULL;
+    }
     
+    auto next = std::chrono::steady_clock::now();
     while (g->gameRunning && !g->returnToMenu) {
+        g->jitterSim.tick(nowNs());
+        int steps = 1;
         if (!g->paused) {
-            // Bloquear los 3 mutex a la vez (evita deadlocks por orden distinto) para proteger acceso a todos los objetos
-            std::scoped_lock lock(g->mtxAsteroids, g->mtxBullets, g->mtxShips);
-            g->tryCollisions();
+            // con sobrecarga un tick cubre dos periodos: la mitad de trabajo por segundo de juego
+            steps = g->budget.simSteps();
+            g->tickSteps = steps;
+            int64_t t0 = nowNs();
+            g->tickPool.run(g->tickGraph);
+            for (int i = 0; i < steps; ++i) g->scripts.tick();
+            int64_t t1 = nowNs();
+            g->asteroidTickNs = g->bulletTickNs = g->shipTickNs = t1;
+            g->budget.tickDone(t1 - t0, t1);
+            if (g->soak.active()) g->soak.tickCost(t1 - t0);
         }
-        usleep(50000);
+        next += std::chrono::microseconds(SIM_TICK_US * steps);
+        std::this_thread::sleep_until(next);
     }
     
     return NULL;
 }
 
-
 void* Game::drawThread(void* arg) {
     Game* g = (Game*)arg;
+    g->tuneThread("ast-draw", TG_RENDER);
     
+    int64_t last = nowNs();
     while (g->gameRunning && !g->returnToMenu) { 
+        int64_t now = nowNs();
+        g->jitterRender.tick(now);
+        // particulas en tiempo real (no en ticks): se frenan en pausa
+        float dt = g->paused ? 0.0f : (float)std::min((now - last) / 1e9, 0.1);
+        last = now;
+        g->particles.update(dt);
         {
             std::lock_guard<std::mutex> lock(g->mtxNcurses);
             if (g->gameRunning) {  // Verificar nuevamente dentro del mutex
+                g->inputLatency.frameBegin(nowNs());
                 g->drawAll();
+                int64_t shown = nowNs();
+                g->inputLatency.frameShown(shown);
+                g->budget.frameDone(shown - now);
+                if (g->spectators.wanted()) g->captureSpectatorFrame();
             }
         }
-        usleep(33000);
+        usleep(DRAW_INTERVAL_US * g->budget.renderDiv());
     }
     
     return NULL;
 }
 
-void* Game::gameLogicThread(void* arg) {
+void* Game::hudUpdateThread(void* arg) {
     Game* g = (Game*)arg;
+    g->tuneThread("ast-hud", TG_RENDER);
+    int64_t lastCheckpoint = nowNs();
     
-    while (g->gameRunning && !g->returnToMenu) { 
-        if (!g->paused) {
-            bool shouldEnd = false;
-            {
-                std::lock_guard<std::mutex> lock(g->mtxShips);
-                if (g->mode == 3) {
-                    if (g->player.lives.load() <= 0 && g->player2.lives.load() <= 0) {
-                        shouldEnd = true;
-                    }
-                    else if (g->player.score.load() >= g->winScore || g->player2.score.load() >= g->winScore) {
-                        shouldEnd = true;
-                    }
-                } else {
-                    if (g->player.lives.load() <= 0) {
-                        shouldEnd = true;
-                    }
-                    else if (g->player.score.load() >= g->winScore) {
-                        shouldEnd = true;
-                    }
-                }
-            }
-            
-            if (shouldEnd) {
-                g->gameRunning = false;
-                g->returnToMenu = true;
-                break;
-            }
+    while (g->gameRunning && !g->returnToMenu) {
+        // checkpoint: la copia se hace bajo los locks (memcpy de los vectores),
+        // el archivo lo escribe el hilo de SnapshotWriter
+        if (!g->lockstep && !g->paused && nowNs() - lastCheckpoint >= CHECKPOINT_INTERVAL_NS) {
+            g->captureCheckpoint(g->checkpointBuf);
+            g->checkpoints.submit(g->checkpointBuf);
+            lastCheckpoint = nowNs();
         }
-        usleep(50000); 
+        usleep(200000);
     }
     
     return NULL;
 }
 
+void Game::tuneThread(const char* name, ThreadGroup group) {
+    std::string err;
+    if (!tuneCurrentThread(name, config.groups[group], err)) {
+        std::lock_guard<std::mutex> lock(mtxTuning);
+        tuningErrors += err;
+    }
+}
+
+// una entrada por partida en debug.log: comparar antes/despues de cambiar asteroids.conf
+void Game::writeJitterReport() {
+    FILE* f = fopen(logPath.c_str(), "a");
+    if (!f) return;
+    time_t now = time(nullptr);
+    char when[32];
+    strftime(when, sizeof(when), "%Y-%m-%d %H:%M:%S", localtime(&now));
+    fprintf(f, "[%s] jitter modo %d | %s\n", when, mode, config.describe().c_str());
+
+    struct Row { const char* name; const JitterStats* st; int periodUs; };
+    Row rows[] = {
+        { "sim", &jitterSim, SIM_TICK_US },
+        { "render", &jitterRender, DRAW_INTERVAL_US },
+        { "input", &jitterInput, 20000 },
+    };
+    for (auto &r : rows) {
+        fprintf(f, "  %-6s n=%-6llu periodo=%dus media=%.1fus desv=%.1fus max=%.1fus\n",
+                r.name, (unsigned long long)r.st->count(), r.periodUs,
+                r.st->meanUs(), r.st->stddevUs(), r.st->maxUs());
+    }
+    budget.report(f, nowNs());
+    std::lock_guard<std::mutex> lock(mtxTuning);
+    if (!tuningErrors.empty()) fprintf(f, "  rechazado: %s\n", tuningErrors.c_str());
+    fclose(f);
+}
+
+void Game::writeLatencyReport() {
+    FILE* f = fopen(logPath.c_str(), "a");
+    if (!f) return;
+    fprintf(f, "  tecla -> pantalla (modo %d%s):\n", mode, lockstep ? ", lockstep" : "");
+    inputLatency.report(f, config.latencyTargetMs);
+    fclose(f);
+}
+
 //============================================================================
-// HILOS AUXILIARES (5)
+// LÓGICA DEL JUEGO
 //============================================================================
 
-void* Game::asteroidUpdateThread(void* arg) {
-    Game* g = (Game*)arg;
-    
-    while (g->gameRunning && !g->returnToMenu) {
-        if (!g->paused) {
-            std::lock_guard<std::mutex> lock(g->mtxAsteroids);
-            for (auto &a : g->asteroids) {
-                a.update(0.033, g->maxx, g->maxy);
-            }
+// un tick de simulacion:
+//
+//   naves --> asteroides --+                         +--> oyentes (HUD, stats, log)
+//                          +--> colisiones --> aplicar
+//   balas -----------------+                         +--> reglas (ganar/perder)
+//
+// asteroides y balas corren en paralelo; colisiones arranca apenas terminan las dos y solo
+// genera eventos (sin el lock global); aplicar los vuelca al estado con los tres mutex.
+// cada etapa sigue tomando su mutex porque input y dibujo leen/escriben fuera del grafo
+void Game::buildTickGraph() {
+    tickGraph.clear();
+    // tickSteps lo fija updateThread antes de cada run (2 = pasos juntados por sobrecarga)
+    int ships = tickGraph.add("naves", [this] {
+        std::lock_guard<std::mutex> lock(mtxShips);
+        // dos naves: se mantienen los pasos reales (la friccion es por paso).
+        // prev queda en la posicion de antes del primero: el dibujo interpola todo el periodo juntado
+        Vec2 prev1 = player.pos, prev2 = player2.pos;
+        for (int i = tickSteps; i > 0; --i) {
+            player.update(0.033, worldW, worldH);
+            if (mode == 3) player2.update(0.033, worldW, worldH);
+        }
+        player.prev = prev1;
+        if (mode == 3) player2.prev = prev2;
+    });
+    int ast = tickGraph.add("asteroides", [this] {
+        Vec2 s1, s2;
+        {
+            std::lock_guard<std::mutex> lock(mtxShips);
+            s1 = player.pos;
+            s2 = (mode == 3) ? player2.pos : player.pos;
+        }
+        std::lock_guard<std::mutex> lock(mtxAsteroids);
+        stepAsteroids(s1, s2, tickSteps);
+    });
+    int bul = tickGraph.add("balas", [this] {
+        std::lock_guard<std::mutex> lock(mtxBullets);
+        stepBullets(BULLET_STEP, tickSteps);
+    });
+    int detect = tickGraph.add("colisiones", [this] {
+        detectCollisions(tickEvents);
+    });
+    int apply = tickGraph.add("aplicar", [this] {
+        std::scoped_lock lock(mtxAsteroids, mtxBullets, mtxShips);
+        applyEvents(tickEvents);
+    });
+    int listen = tickGraph.add("oyentes", [this] {
+        events.dispatch(tickEvents, asteroidTick);
+    });
+    int rules = tickGraph.add("reglas", [this] {
+        checkWinLoseConditions();
+    });
+    tickGraph.depend(ast, ships);
+    tickGraph.depend(detect, ast);
+    tickGraph.depend(detect, bul);
+    tickGraph.depend(apply, detect);
+    tickGraph.depend(listen, apply);
+    tickGraph.depend(rules, apply);
+}
+
+void Game::stepAsteroids(const Vec2& s1, const Vec2& s2, int steps) {
+    // el radio "lejos" sale del mundo y no de la terminal local: en red tiene que ser igual en ambos
+    double farX = (worldW / WORLD_SCALE) * FAR_VIEWS;
+    double farY = (worldH / WORLD_SCALE) * FAR_VIEWS;
+
+    unsigned tick = asteroidTick++;
+    for (size_t i = 0; i < asteroids.size(); ++i) {
+        Asteroid &a = asteroids[i];
+        bool far1 = fabs(wrapDelta(a.pos.x - s1.x, worldW)) > farX || fabs(wrapDelta(a.pos.y - s1.y, worldH)) > farY;
+        bool far2 = fabs(wrapDelta(a.pos.x - s2.x, worldW)) > farX || fabs(wrapDelta(a.pos.y - s2.y, worldH)) > farY;
+        if (!far1 || !far2) {
+            a.update(0.033 * steps, worldW, worldH);
+        } else if ((tick + i) % FAR_TICK_DIV == 0) {
+            // lejos de todos: un paso largo cada FAR_TICK_DIV ticks (escalonado por indice)
+            a.update(0.033 * FAR_TICK_DIV * steps, worldW, worldH);
+        } else {
+            a.prev = a.pos;
         }
-        usleep(33000);
     }
-    
-    return NULL;
+    asteroidGrid.build(asteroids, worldW, worldH);
 }
 
-void* Game::projectileUpdateThread(void* arg) {
-    Game* g = (Game*)arg;
-    
-    while (g->gameRunning && !g->returnToMenu) {
-        if (!g->paused) {
-            std::lock_guard<std::mutex> lock(g->mtxBullets);
-            for (auto &b : g->bullets) {
-                b.update(0.2, g->maxx, g->maxy);
+// steps > 1: un solo avance largo (el barrido lo cubre entero) y la vida baja igual que con pasos sueltos
+void Game::stepBullets(double dt, int steps) {
+    for (auto &b : bullets) {
+        b.update(dt * steps, worldW, worldH);
+        b.life -= steps - 1;
+    }
+    bullets.erase(
+        std::remove_if(bullets.begin(), bullets.end(),
+            [](const Projectile& p){ return !p.alive(); }),
+        bullets.end()
+    );
+}
+
+// un tick de la partida en red: se manda la entrada local para t+INPUT_DELAY, se espera la
+// del otro para t y los dos procesos simulan exactamente el mismo paso (P1 = host)
+void Game::lockstepLoop() {
+    const int D = Lockstep::INPUT_DELAY;
+    uint8_t localKeys[D + 1];
+    int64_t localKeysNs[D + 1]; // lectura de la tecla mas vieja de cada frame local (latencia)
+    uint32_t csTick = NO_CHECKSUM, csValue = 0;
+
+    // los primeros D ticks no tienen entrada de nadie
+    for (int t = 0; t < D; ++t) {
+        localKeys[t] = 0;
+        localKeysNs[t] = 0;
+        InputFrame f;
+        memset(&f, 0, sizeof(f));
+        f.tick = t;
+        f.csTick = NO_CHECKSUM;
+        if (!net.send(f)) netError = "Conexion perdida";
+    }
+
+    auto next = std::chrono::steady_clock::now();
+    for (uint32_t t = 0; netError.empty() && gameRunning && !returnToMenu; ++t) {
+        jitterSim.tick(nowNs());
+        InputFrame out;
+        memset(&out, 0, sizeof(out));
+        out.tick = t + D;
+        out.keys = netKeys.exchange(0);
+        out.csTick = csTick;
+        out.checksum = csValue;
+        localKeys[(t + D) % (D + 1)] = out.keys;
+        localKeysNs[(t + D) % (D + 1)] = netKeysNs.exchange(0);
+
+        InputFrame in;
+        if (!net.send(out) || !net.recv(in, Lockstep::RECV_TIMEOUT_MS) || in.tick != t) {
+            netError = "Conexion perdida";
+            break;
+        }
+        if (!net.checkRemote(in)) {
+            netError = "DESYNC: las simulaciones divergieron";
+            break;
+        }
+
+        uint8_t mine = localKeys[t % (D + 1)];
+        uint8_t k1 = (net.role == NET_HOST) ? mine : in.keys;
+        uint8_t k2 = (net.role == NET_HOST) ? in.keys : mine;
+        if ((k1 | k2) & IN_QUIT) break;
+        if ((k1 | k2) & IN_PAUSE) paused = !paused;
+
+        if (!paused) {
+            {
+                std::scoped_lock lock(mtxShips, mtxBullets);
+                applyKeys(player, k1, 1);
+                applyKeys(player2, k2, 2);
             }
-            g->bullets.erase(
-                std::remove_if(g->bullets.begin(), g->bullets.end(),
-                    [](const Projectile& p){ return !p.alive(); }),
-                g->bullets.end()
-            );
+            // el grafo fija el orden entre etapas: mismo resultado en los dos procesos
+            int64_t t0 = nowNs();
+            tickPool.run(tickGraph);
+            scripts.tick();
+            int64_t t1 = nowNs();
+            asteroidTickNs = bulletTickNs = shipTickNs = t1;
+            budget.tickDone(t1 - t0, t1); // tope 1: solo cambia la frecuencia de dibujo
+            // en lockstep la tecla recien afecta al estado INPUT_DELAY ticks despues
+            if (localKeysNs[t % (D + 1)] != 0) inputLatency.inputApplied(localKeysNs[t % (D + 1)], nowNs());
+        }
+
+        if (t % Lockstep::CHECKSUM_EVERY == 0) {
+            csTick = t;
+            csValue = stateChecksum();
+            net.recordChecksum(csTick, csValue);
         }
-        usleep(25000);
+
+        next += std::chrono::microseconds(SIM_TICK_US);
+        std::this_thread::sleep_until(next);
     }
-    
-    return NULL;
+
+    gameRunning = false;
+    returnToMenu = true;
 }
 
-void* Game::ship1UpdateThread(void* arg) {
-    Game* g = (Game*)arg;
-    
-    while (g->gameRunning && !g->returnToMenu) {
-        if (!g->paused) {
-            std::lock_guard<std::mutex> lock(g->mtxShips);
-            g->player.update(0.033, g->maxx, g->maxy);
+// FNV-1a sobre los registros compactos de todo lo simulado
+uint32_t Game::stateChecksum() {
+    uint32_t h = 2166136261u;
+    auto mix = [&h](const void* p, size_t n) {
+        const unsigned char* b = (const unsigned char*)p;
+        for (size_t i = 0; i < n; ++i) {
+            h ^= b[i];
+            h *= 16777619u;
         }
-        usleep(33000);
-    }
-    
-    return NULL;
+    };
+
+    std::scoped_lock lock(mtxAsteroids, mtxBullets, mtxShips);
+    for (auto &a : asteroids) { PackedBody pb = a.pack(); mix(&pb, sizeof(pb)); }
+    for (auto &b : bullets) { PackedBody pb = b.pack(); mix(&pb, sizeof(pb)); }
+    PackedBody s1 = player.pack(1), s2 = player2.pack(2);
+    mix(&s1, sizeof(s1));
+    mix(&s2, sizeof(s2));
+    int stats[4] = { player.lives.load(), player.score.load(), player2.lives.load(), player2.score.load() };
+    mix(stats, sizeof(stats));
+    mix(&rng.state, sizeof(rng.state));
+    return h;
 }
 
-void* Game::ship2UpdateThread(void* arg) {
-    Game* g = (Game*)arg;
-    
-    if (g->mode != 3) return NULL;
-    
-    while (g->gameRunning && !g->returnToMenu) {
-        if (!g->paused) {
-            std::lock_guard<std::mutex> lock(g->mtxShips);
-            g->player2.update(0.033, g->maxx, g->maxy);
+Ship& Game::localShip() {
+    return (net.role == NET_JOIN) ? player2 : player;
+}
+
+// cada REINFORCE_TICKS, si quedan pocos asteroides, entran dos grandes lejos de las naves
+Script Game::reinforcementScript() {
+    while (true) {
+        co_await scripts.ticks(REINFORCE_TICKS);
+
+        Vec2 s1;
+        {
+            std::lock_guard<std::mutex> lock(mtxShips);
+            s1 = player.pos;
         }
-        usleep(33000);
+        std::lock_guard<std::mutex> lock(mtxAsteroids);
+        if ((int)asteroids.size() >= waveSize() / 2) continue;
+        for (int k = 0; k < 2; ++k) {
+            Vec2 p;
+            p.x = s1.x + worldW / 2.0 + (k == 0 ? 6.0 : -6.0);
+            p.y = s1.y + worldH / 2.0;
+            wrapPosition(p, worldW, worldH);
+            double vx = (rng.range(200) / 100.0 - 1.0) * 0.8;
+            double vy = (rng.range(200) / 100.0 - 1.0) * 0.8;
+            asteroids.emplace_back(p.x, p.y, vx, vy, 3);
+        }
+        asteroidGrid.build(asteroids, worldW, worldH);
     }
-    
-    return NULL;
 }
 
-void* Game::hudUpdateThread(void* arg) {
-    Game* g = (Game*)arg;
-    
-    while (g->gameRunning && !g->returnToMenu) {
-        usleep(200000);
+// muestra un aviso en el HUD cada vez que ocurre el evento
+Script Game::bannerScript(int event, const char* text) {
+    while (true) {
+        co_await scripts.event(event);
+        {
+            std::lock_guard<std::mutex> lock(mtxGameState);
+            hudMessage = text;
+        }
+        co_await scripts.ticks(BANNER_TICKS);
+        {
+            std::lock_guard<std::mutex> lock(mtxGameState);
+            if (hudMessage == text) hudMessage.clear();
+        }
     }
-    
-    return NULL;
 }
 
-//============================================================================
-// LÓGICA DEL JUEGO
-//============================================================================
-
 void Game::handleInput(int ch) {
     std::lock_guard<std::mutex> lockShips(mtxShips);
     std::lock_guard<std::mutex> lockBul(mtxBullets);
     
     // Player 1 controls
     if (ch == 'a' || ch == 'A') {
-        player.rotateLeft(0.3);
+        player.rotateLeft();
     }
     else if (ch == 'd' || ch == 'D') {
-        player.rotateRight(0.3);
+        player.rotateRight();
     }
     else if (ch == 'w' || ch == 'W') {
         player.thrust(0.3);
+        thrustTrail(player, 1);
     }
     else if (ch == ' ') {
-        double speed = 10.0;
-        double vx = cos(player.angle) * speed + player.vel.x;
-        double vy = sin(player.angle) * speed + player.vel.y;
-        bullets.emplace_back(player.pos.x + cos(player.angle), player.pos.y + sin(player.angle), vx, vy, 15, 1);
+        fireBullet(player, 1);
     }
 
     // Player 2 (solo en modo 3)
     if (mode == 3) {
         if (ch == KEY_LEFT) {
-            player2.rotateLeft(0.3);
+            player2.rotateLeft();
         }
         else if (ch == KEY_RIGHT) {
-            player2.rotateRight(0.3);
+            player2.rotateRight();
         }
         else if (ch == KEY_UP) {
             player2.thrust(0.3);
+            thrustTrail(player2, 2);
         }
         else if (ch == '\n' || ch == KEY_ENTER) {
-            double speed = 10.0;
-            double vx = cos(player2.angle) * speed + player2.vel.x;
-            double vy = sin(player2.angle) * speed + player2.vel.y;
-            bullets.emplace_back(player2.pos.x + cos(player2.angle), player2.pos.y + sin(player2.angle), vx, vy, 15, 2);
+            fireBullet(player2, 2);
         }
     }
 
@@ -428,140 +860,380 @@ void Game::handleInput(int ch) {
     }
 }
 
-void Game::tryCollisions() {
-    std::vector<Asteroid> newAst;
-    std::vector<size_t> astToErase;
-    std::vector<size_t> bulToErase;
+void Game::fireBullet(const Ship& s, int owner) {
+    double speed = 10.0;
+    double dx = s.dirX();
+    double dy = s.dirY();
+    double vx = dx * speed + s.vel.x;
+    double vy = dy * speed + s.vel.y;
+    bullets.emplace_back(s.pos.x + dx, s.pos.y + dy, vx, vy, 15, owner);
+}
+
+// estela del impulso: sale por detras de la nave, en sentido contrario al rumbo
+void Game::thrustTrail(const Ship& s, int owner) {
+    double speed = 8.0;
+    particles.trail(s.pos.x - s.dirX(), s.pos.y - s.dirY(), -s.dirX() * speed, -s.dirY() * speed,
+                    owner == 2 ? PK_SHIP2 : PK_SHIP1);
+}
+
+// en red cada jugador usa su propia terminal: acepta las dos distribuciones de teclas
+uint8_t Game::keyBits(int ch) {
+    switch (ch) {
+    case 'a': case 'A': case KEY_LEFT:  return IN_LEFT;
+    case 'd': case 'D': case KEY_RIGHT: return IN_RIGHT;
+    case 'w': case 'W': case KEY_UP:    return IN_THRUST;
+    case ' ': case '\n': case KEY_ENTER: return IN_FIRE;
+    case 'p': case 'P': return IN_PAUSE;
+    case 'q': case 'Q': return IN_QUIT;
+    }
+    return 0;
+}
+
+void Game::applyKeys(Ship& s, uint8_t keys, int owner) {
+    if (keys & IN_LEFT) s.rotateLeft();
+    if (keys & IN_RIGHT) s.rotateRight();
+    if (keys & IN_THRUST) {
+        s.thrust(0.3);
+        thrustTrail(s, owner);
+    }
+    if (keys & IN_FIRE) fireBullet(s, owner);
+}
+
+// deteccion: solo lee y agrega eventos, no cambia nada.
+// los asteroides solo se escriben dentro del grafo (y de los scripts, despues), asi que aqui
+// se leen sin lock; de las balas y las naves (que toca inputThread) se copia lo necesario
+void Game::detectCollisions(std::vector<GameEvent>& out) {
+    out.clear();
+    {
+        std::lock_guard<std::mutex> lock(mtxBullets);
+        bulletScratch = bullets;
+    }
+    Vec2 ships[2];
+    {
+        std::lock_guard<std::mutex> lock(mtxShips);
+        ships[0] = player.pos;
+        ships[1] = player2.pos;
+    }
+    astFlags.assign(asteroids.size(), 0); // asteroide ya destruido en este tick
+    bulFlags.assign(bulletScratch.size(), 0);
 
     // bullets vs asteroids
     for (size_t i = 0; i < asteroids.size(); ++i) {
-        for (size_t j = 0; j < bullets.size(); ++j) {
-            if (std::find(bulToErase.begin(), bulToErase.end(), j) != bulToErase.end()) {
-                continue;
-            }
-            
-            double d = dist(asteroids[i].pos.x, asteroids[i].pos.y, 
-                          bullets[j].pos.x, bullets[j].pos.y);
-            
-            if (d <= (asteroids[i].radius() + 0.5)) {
-                bulToErase.push_back(j);
-                
-                if (asteroids[i].size >= 2) {
-                    for (int k = 0; k < 2; ++k) {
-                        double nx = asteroids[i].pos.x + (k == 0 ? 1.5 : -1.5);
-                        double ny = asteroids[i].pos.y + (k == 0 ? 0.5 : -0.5);
-                        double nvx = asteroids[i].vel.x + ((rand() % 200) / 100.0 - 1.0) * 0.8;
-                        double nvy = asteroids[i].vel.y + ((rand() % 200) / 100.0 - 1.0) * 0.8;
-                        newAst.emplace_back(nx, ny, nvx, nvy, 1);
-                    }
-                }
-                
-                if (asteroids[i].size == 1) {
-                    if (bullets[j].owner == 1) player.score.fetch_add(10);
-                    else if (bullets[j].owner == 2) player2.score.fetch_add(10);
-                }
-                
-                astToErase.push_back(i);
-                break;
+        const Asteroid &a = asteroids[i];
+        for (size_t j = 0; j < bulletScratch.size(); ++j) {
+            if (bulFlags[j]) continue;
+            const Projectile &b = bulletScratch[j];
+            // segmento recorrido desde la ultima revision: no se escapan balas rapidas
+            Vec2 from;
+            from.x = b.pos.x - b.sweep.x;
+            from.y = b.pos.y - b.sweep.y;
+            if (!bulletHitsAsteroid(from, b.pos, a)) continue;
+
+            bulFlags[j] = 1;
+            astFlags[i] = 1;
+            out.push_back(makeEvent(EV_BULLET_HIT, b.owner, a.size, (int)i, (int)j, a.pos.x, a.pos.y));
+            if (a.size == 1 && (b.owner == 1 || b.owner == 2)) {
+                out.push_back(makeEvent(EV_SCORE, b.owner, a.size, (int)i, 10, a.pos.x, a.pos.y));
             }
+            break;
         }
     }
 
-    // eliminar balas y asteroides marcados
-    std::sort(bulToErase.begin(), bulToErase.end());
-    bulToErase.erase(std::unique(bulToErase.begin(), bulToErase.end()), bulToErase.end());
-    for (int k = (int)bulToErase.size()-1; k >= 0; --k) {
-        if (bulToErase[k] < bullets.size()) {
-            bullets.erase(bullets.begin() + bulToErase[k]);
+    // ship vs asteroids: un choque por nave y por tick
+    int nShips = (mode == 3) ? 2 : 1;
+    for (int s = 0; s < nShips; ++s) {
+        for (size_t i = 0; i < asteroids.size(); ++i) {
+            if (astFlags[i] || !shipHitsAsteroid(ships[s], asteroids[i])) continue;
+            astFlags[i] = 1;
+            out.push_back(makeEvent(EV_SHIP_DESTROYED, s + 1, asteroids[i].size, (int)i, -1, ships[s].x, ships[s].y));
+            break;
         }
     }
+}
+
+// consumidor de estado: aplica los eventos en orden y agrega los que resultan
+// (partidos, oleada nueva) para los oyentes
+void Game::applyEvents(std::vector<GameEvent>& ev) {
+    astFlags.assign(asteroids.size(), 0); // se borra al compactar
+    bulFlags.assign(bullets.size(), 0);
+    std::vector<Asteroid> born;
+
+    auto destroy = [&](int a) {
+        if (a < 0 || a >= (int)asteroids.size() || astFlags[a]) return;
+        astFlags[a] = 1;
+        const Asteroid &ast = asteroids[a];
+        if (ast.size >= 2) {
+            splitAsteroid(ast, born);
+            ev.push_back(makeEvent(EV_ASTEROID_SPLIT, 0, ast.size, a, 0, ast.pos.x, ast.pos.y));
+        }
+    };
 
-    // eliminar asteroides y agregar nuevos
-    std::sort(astToErase.begin(), astToErase.end());
-    astToErase.erase(std::unique(astToErase.begin(), astToErase.end()), astToErase.end());
-    for (int k = (int)astToErase.size()-1; k >= 0; --k) {
-        if (astToErase[k] < asteroids.size()) {
-            asteroids.erase(asteroids.begin() + astToErase[k]);
+    size_t n = ev.size(); // lo que se agrega aca no se vuelve a aplicar
+    for (size_t k = 0; k < n; ++k) {
+        GameEvent e = ev[k]; // copia: destroy puede hacer crecer ev
+        Ship &ship = (e.player == 2) ? player2 : player;
+        switch (e.type) {
+        case EV_BULLET_HIT:
+            if (e.b >= 0 && e.b < (int)bulFlags.size()) bulFlags[e.b] = 1;
+            destroy(e.a);
+            break;
+        case EV_SHIP_DESTROYED:
+            ship.lives.fetch_sub(1);
+            ship.reset((e.player == 2 ? 2 : 1) * worldW / 3.0, worldH / 2.0);
+            destroy(e.a);
+            break;
+        case EV_SCORE:
+            ship.score.fetch_add(e.b);
+            break;
         }
     }
-    
-    for (auto &na : newAst) asteroids.push_back(na);
 
-    // ship vs asteroids (player 1) 
+    size_t k = 0;
     for (size_t i = 0; i < asteroids.size(); ++i) {
-        double d = dist(player.pos.x, player.pos.y, 
-                       asteroids[i].pos.x, asteroids[i].pos.y);
-        
-        if (d <= (asteroids[i].radius() + 1.0)) {
-            player.lives.fetch_sub(1);  
-            player.reset(maxx/3.0, maxy/2.0);
-            
-            if (asteroids[i].size >= 2) {
-                for (int k = 0; k < 2; ++k) {
-                    double nx = asteroids[i].pos.x + (k == 0 ? 1.5 : -1.5);
-                    double ny = asteroids[i].pos.y + (k == 0 ? 0.5 : -0.5);
-                    double nvx = asteroids[i].vel.x + ((rand() % 200) / 100.0 - 1.0) * 0.8;
-                    double nvy = asteroids[i].vel.y + ((rand() % 200) / 100.0 - 1.0) * 0.8;
-                    asteroids.emplace_back(nx, ny, nvx, nvy, 1);
-                }
-            }
-            asteroids.erase(asteroids.begin()+i);
-            break;
+        if (!astFlags[i]) asteroids[k++] = asteroids[i];
+    }
+    asteroids.erase(asteroids.begin() + k, asteroids.end());
+    asteroids.insert(asteroids.end(), born.begin(), born.end());
+
+    k = 0;
+    for (size_t j = 0; j < bullets.size(); ++j) {
+        if (!bulFlags[j]) bullets[k++] = bullets[j];
+    }
+    bullets.erase(bullets.begin() + k, bullets.end());
+    for (auto &b : bullets) b.sweep = Vec2();
+
+    // asteroides entre si (rebotes elasticos)
+    resolveAsteroidCollisions();
+
+    // reponer asteroides si no quedan: se intercambia la oleada ya generada
+    // (si todavia no esta lista, se genera aqui como antes) y se pide la siguiente
+    if (asteroids.empty()) {
+        Vec2 s2 = (mode == 3) ? player2.pos : player.pos;
+        if (lockstep || !waveGen.take(asteroids, player.pos, s2)) {
+            spawnInitialAsteroids();
         }
+        if (!lockstep) requestNextWave();
+        ev.push_back(makeEvent(EV_WAVE_CLEARED, 0, 0, -1, 0, 0, 0));
     }
 
-    // ship vs asteroids (player 2)
-    if (mode == 3) {
-        for (size_t i = 0; i < asteroids.size(); ++i) {
-            double d = dist(player2.pos.x, player2.pos.y, 
-                           asteroids[i].pos.x, asteroids[i].pos.y);
-            
-            if (d <= (asteroids[i].radius() + 1.0)) {
-                player2.lives.fetch_sub(1); 
-                player2.reset(2*maxx/3.0, maxy/2.0);
-                
-                if (asteroids[i].size >= 2) {
-                    for (int k = 0; k < 2; ++k) {
-                        double nx = asteroids[i].pos.x + (k == 0 ? 1.5 : -1.5);
-                        double ny = asteroids[i].pos.y + (k == 0 ? 0.5 : -0.5);
-                        double nvx = asteroids[i].vel.x + ((rand() % 200) / 100.0 - 1.0) * 0.8;
-                        double nvy = asteroids[i].vel.y + ((rand() % 200) / 100.0 - 1.0) * 0.8;
-                        asteroids.emplace_back(nx, ny, nvx, nvy, 1);
-                    }
-                }
-                asteroids.erase(asteroids.begin()+i);
-                break;
+    // los indices cambiaron (splits, borrados): la grilla del dibujo se rehace
+    asteroidGrid.build(asteroids, worldW, worldH);
+}
+
+// oyentes fijos; corren en la tarea "oyentes" del grafo, despues de aplicar
+void Game::subscribeListeners() {
+    // HUD: avisos de los scripts
+    events.subscribe([this](const std::vector<GameEvent>& evs, uint32_t) {
+        for (auto &e : evs) {
+            if (e.type == EV_SHIP_DESTROYED) scripts.emit(SEVT_SHIP_LOST);
+            else if (e.type == EV_WAVE_CLEARED) scripts.emit(SEVT_WAVE_CLEARED);
+        }
+    });
+    // efectos: restos del asteroide, y una explosion mas grande si cae una nave
+    events.subscribe([this](const std::vector<GameEvent>& evs, uint32_t) {
+        for (auto &e : evs) {
+            if (e.type == EV_BULLET_HIT) particles.explode(e.x, e.y, 4 * e.size, PK_DEBRIS);
+            else if (e.type == EV_SHIP_DESTROYED) {
+                particles.explode(e.x, e.y, 24, e.player == 2 ? PK_SHIP2 : PK_SHIP1);
             }
         }
+    });
+    // estadisticas de la partida
+    events.subscribe([this](const std::vector<GameEvent>& evs, uint32_t) {
+        stats.add(evs);
+    });
+    // log de eventos (tick + registro fijo), si esta configurado
+    events.subscribe([this](const std::vector<GameEvent>& evs, uint32_t tick) {
+        if (!eventLogFile) return;
+        for (auto &e : evs) {
+            fwrite(&tick, sizeof(tick), 1, eventLogFile);
+            fwrite(&e, sizeof(e), 1, eventLogFile);
+        }
+    });
+}
+
+void Game::writeStatsReport() {
+    FILE* f = fopen(logPath.c_str(), "a");
+    if (!f) return;
+    fprintf(f, "  eventos: destruidos %u/%u/%u (peq/med/gra) partidos=%u oleadas=%u naves perdidas P1=%u P2=%u puntos P1=%u P2=%u\n",
+            stats.destroyed[1], stats.destroyed[2], stats.destroyed[3], stats.splits, stats.waves,
+            stats.shipsLost[1], stats.shipsLost[2], stats.points[1], stats.points[2]);
+    if (particles.dropped() || particles.skipped()) {
+        fprintf(f, "  particulas: %llu pisadas antes de tiempo, %llu no creadas por el tope por cuadro (capacidad %d)\n",
+                (unsigned long long)particles.dropped(), (unsigned long long)particles.skipped(), particles.capacity());
     }
+    fclose(f);
+}
 
-    // reponer asteroides si no quedan
-    if (asteroids.empty()) {
-        spawnInitialAsteroids();
+// un asteroide grande se parte en dos del tamaño siguiente, separados para no tocarse
+void Game::splitAsteroid(const Asteroid& a, std::vector<Asteroid>& out) {
+    if (a.size < 2) return;
+    Asteroid child(0, 0, 0, 0, a.size - 1);
+    double off = child.radius() + 0.6;
+    for (int k = 0; k < 2; ++k) {
+        double nx = a.pos.x + (k == 0 ? off : -off);
+        double ny = a.pos.y + (k == 0 ? 0.5 : -0.5);
+        double nvx = a.vel.x + (rng.range(200) / 100.0 - 1.0) * 0.8;
+        double nvy = a.vel.y + (rng.range(200) / 100.0 - 1.0) * 0.8;
+        out.emplace_back(nx, ny, nvx, nvy, a.size - 1);
+    }
+}
+
+// diferencia en celdas entre dos coordenadas, por el lado corto del mundo
+static int cellDelta(double from, double to, int size) {
+    int d = (int)round(to) - (int)round(from);
+    if (d >= size/2) d -= size;
+    else if (d < -size/2) d += size;
+    return d;
+}
+
+// circulo primero (barato); si pasa, se recorre el segmento celda por celda contra la mascara
+bool Game::bulletHitsAsteroid(const Vec2& rawFrom, const Vec2& rawTo, const Asteroid& a) {
+    // mundo toroidal: el segmento se lleva a la copia mas cercana del asteroide (diferencias
+    // cortas), asi una bala que cruza el borde en este tick no barre el mundo entero
+    Vec2 to, from;
+    to.x = a.pos.x + wrapDelta(rawTo.x - a.pos.x, worldW);
+    to.y = a.pos.y + wrapDelta(rawTo.y - a.pos.y, worldH);
+    from.x = to.x + wrapDelta(rawFrom.x - rawTo.x, worldW);
+    from.y = to.y + wrapDelta(rawFrom.y - rawTo.y, worldH);
+    if (!segmentHitsCircle(from, to, a.pos, a.radius() + 0.5)) return false;
+    const Sprite& sp = a.sprite();
+    double len = dist(from.x, from.y, to.x, to.y);
+    int steps = (int)ceil(len) + 1;
+    for (int k = 0; k <= steps; ++k) {
+        double t = (double)k / steps;
+        double x = from.x + (to.x - from.x) * t;
+        double y = from.y + (to.y - from.y) * t;
+        if (spriteHasCell(sp, cellDelta(a.pos.x, x, worldW), cellDelta(a.pos.y, y, worldH))) return true;
+    }
+    return false;
+}
+
+bool Game::shipHitsAsteroid(const Vec2& ship, const Asteroid& a) {
+    double dx = wrapDelta(ship.x - a.pos.x, worldW);
+    double dy = wrapDelta(ship.y - a.pos.y, worldH);
+    double r = a.radius() + 1.0;
+    if (dx*dx + dy*dy > r*r) return false;
+    return spriteHasCell(a.sprite(), cellDelta(a.pos.x, ship.x, worldW), cellDelta(a.pos.y, ship.y, worldH));
+}
+
+void Game::resolveAsteroidCollisions() {
+    asteroidSap.findPairs(asteroids, asteroidPairs);
+
+    for (auto &pr : asteroidPairs) {
+        Asteroid &a = asteroids[pr.first];
+        Asteroid &b = asteroids[pr.second];
+        double dx = b.pos.x - a.pos.x;
+        double dy = b.pos.y - a.pos.y;
+        double rsum = a.radius() + b.radius();
+        double d2 = dx*dx + dy*dy;
+        if (d2 >= rsum*rsum || d2 == 0.0) continue;
+        // circulos solapados: confirmar con las mascaras (AND por fila)
+        if (!spritesOverlap(a.sprite(), b.sprite(), cellDelta(a.pos.x, b.pos.x, worldW), cellDelta(a.pos.y, b.pos.y, worldH))) continue;
+
+        double d = sqrt(d2);
+        double nx = dx / d;
+        double ny = dy / d;
+        // masa proporcional al area
+        double ma = a.radius() * a.radius();
+        double mb = b.radius() * b.radius();
+
+        // separar segun la masa para que no queden pegados
+        double pen = rsum - d;
+        a.pos.x -= nx * pen * mb / (ma + mb);
+        a.pos.y -= ny * pen * mb / (ma + mb);
+        b.pos.x += nx * pen * ma / (ma + mb);
+        b.pos.y += ny * pen * ma / (ma + mb);
+
+        // impulso solo si se estan acercando
+        double vn = (b.vel.x - a.vel.x) * nx + (b.vel.y - a.vel.y) * ny;
+        if (vn >= 0) continue;
+        double j = -2.0 * vn / (1.0/ma + 1.0/mb);
+        a.vel.x -= j / ma * nx;
+        a.vel.y -= j / ma * ny;
+        b.vel.x += j / mb * nx;
+        b.vel.y += j / mb * ny;
     }
 }
 
 void Game::checkWinLoseConditions() {
     std::lock_guard<std::mutex> lock(mtxShips);
+    if (matchOver()) {
+        gameRunning = false;
+        returnToMenu = true;
+    }
+}
+
+bool Game::matchOver() const {
     if (mode == 3) {
-        if (player.lives.load() <= 0 && player2.lives.load() <= 0) {
-            gameRunning = false;
-            returnToMenu = true;
-        }
-        else if (player.score.load() >= winScore || player2.score.load() >= winScore) {
-            gameRunning = false;
-            returnToMenu = true;
-        }
-    } else {
-        if (player.lives.load() <= 0) {
-            gameRunning = false;
-            returnToMenu = true;
-        }
-        else if (player.score.load() >= winScore) {
-            gameRunning = false;
-            returnToMenu = true;
-        }
+        return (player.lives.load() <= 0 && player2.lives.load() <= 0)
+            || player.score.load() >= winScore || player2.score.load() >= winScore;
     }
+    return player.lives.load() <= 0 || player.score.load() >= winScore;
+}
+
+static SnapshotShip saveShip(const Ship& s) {
+    SnapshotShip r;
+    memset((void*)&r, 0, sizeof(r));
+    r.pos = s.pos;
+    r.prev = s.prev;
+    r.vel = s.vel;
+    r.dir = s.dir;
+    r.lives = s.lives.load();
+    r.score = s.score.load();
+    return r;
+}
+
+static void loadShip(Ship& s, const SnapshotShip& r) {
+    s.pos = r.pos;
+    s.prev = r.prev;
+    s.vel = r.vel;
+    s.dir = ((r.dir % SHIP_DIRS) + SHIP_DIRS) % SHIP_DIRS;
+    s.lives.store(r.lives);
+    s.score.store(r.score);
+}
+
+void Game::captureCheckpoint(std::string& buf) {
+    SnapshotHeader hdr;
+    memset((void*)&hdr, 0, sizeof(hdr));
+    hdr.mode = mode;
+    hdr.winScore = winScore;
+    hdr.worldW = worldW;
+    hdr.worldH = worldH;
+
+    std::scoped_lock lock(mtxAsteroids, mtxBullets, mtxShips);
+    hdr.asteroidTick = asteroidTick;
+    hdr.rngState = rng.state;
+    hdr.ships[0] = saveShip(player);
+    hdr.ships[1] = saveShip(player2);
+    Snapshot::encode(buf, hdr, asteroids, bullets);
+}
+
+bool Game::restoreCheckpoint() {
+    std::string buf;
+    SnapshotHeader hdr;
+    std::vector<Asteroid> ast;
+    std::vector<Projectile> bul;
+    if (!Snapshot::load(checkpointPath, buf) || !Snapshot::decode(buf, hdr, ast, bul)) return false;
+
+    // el mundo es el de la partida guardada aunque la terminal ahora mida otra cosa
+    getmaxyx(stdscr, maxy, maxx);
+    mode = hdr.mode;
+    winScore = hdr.winScore;
+    worldW = hdr.worldW;
+    worldH = hdr.worldH;
+    paused = false;
+    returnToMenu = false;
+
+    std::scoped_lock lock(mtxAsteroids, mtxBullets, mtxShips);
+    asteroidTick = hdr.asteroidTick;
+    rng.seed(hdr.rngState);
+    loadShip(player, hdr.ships[0]);
+    loadShip(player2, hdr.ships[1]);
+    asteroids.swap(ast);
+    bullets.swap(bul);
+    asteroidGrid.build(asteroids, worldW, worldH);
+    return true;
 }
 
 void Game::showEndGameScreen() {
@@ -600,16 +1272,20 @@ void Game::showEndGameScreen() {
             
             mvprintw(maxy/2 + 3, centerX - (int)winner.size()/2, "%s", winner.c_str());
         }
+        if (!netError.empty()) {
+            mvprintw(maxy/2 - 4, centerX - (int)netError.size()/2, "%s", netError.c_str());
+        }
         
         mvprintw(maxy/2 + 5, centerX - 20, "Presiona cualquier tecla para continuar...");
         refresh();
     }
 
     flushinp();   // limpia buffer
-    getch();      // ahora sí funciona
+    waitKey();    // ahora sí funciona
 
     // Guardar puntajes después de que el jugador presione tecla
-    saveScoresAfterGame(mode == 3);
+    // en red cada proceso guarda solo a su jugador (comparten scores.*)
+    saveScoresAfterGame(mode == 3 && !lockstep);
 
     // Restaurar configuración ncurses
     {
@@ -647,27 +1323,80 @@ void Game::drawAll() {
         if (has_colors()) attroff(COLOR_PAIR(3));
     }
 
-    // asteroides
+    {
+        std::lock_guard<std::mutex> lock(mtxGameState);
+        if (!hudMessage.empty()) {
+            attron(A_BOLD);
+            mvprintw(0, std::max(0, maxx - (int)hudMessage.size() - 2), "%s", hudMessage.c_str());
+            attroff(A_BOLD);
+        }
+    }
+
+    // cada grupo se dibuja entre sus dos ultimos estados completos
+    // (pausado no hay ticks nuevos: se muestra el ultimo estado tal cual)
+    int64_t now = nowNs();
+    int tickUs = SIM_TICK_US * tickSteps.load();
+    double astAlpha = paused ? 1.0 : tickAlpha(now - asteroidTickNs.load(), tickUs);
+    double bulAlpha = paused ? 1.0 : tickAlpha(now - bulletTickNs.load(), tickUs);
+    double shipAlpha = paused ? 1.0 : tickAlpha(now - shipTickNs.load(), tickUs);
+
+    Viewport views[2];
+    int nViews = setupViewports(views, shipAlpha);
+
+    // asteroides: solo las celdas de la grilla que caen dentro de cada vista
     {
         std::lock_guard<std::mutex> lock(mtxAsteroids);
-        for (auto &a : asteroids) {
-            int ax = (int)round(a.pos.x);
-            int ay = (int)round(a.pos.y);
-            if (ax >= 0 && ax < maxx && ay >= 1 && ay < maxy-1) {
-                if (has_colors()) attron(COLOR_PAIR(3));
-                mvaddch(ay, ax, a.glyph());
-                if (has_colors()) attroff(COLOR_PAIR(3));
-            }
+        if (has_colors()) attron(COLOR_PAIR(3));
+        for (int v = 0; v < nViews; ++v) {
+            const Viewport &vw = views[v];
+            double m = 6.0; // margen: medio sprite grande e interpolacion
+            asteroidGrid.query(vw.camX - vw.w/2.0 - m, vw.camY - vw.h/2.0 - m,
+                               vw.camX + vw.w/2.0 + m, vw.camY + vw.h/2.0 + m,
+                [&](int i) {
+                    if (i >= (int)asteroids.size()) return;
+                    const Asteroid &a = asteroids[i];
+                    const Sprite &sp = a.sprite();
+                    Vec2 c = interpPos(a.prev, a.pos, astAlpha);
+                    // ancla en pantalla (puede quedar fuera aunque parte del sprite se vea)
+                    int ax = vw.left + vw.w/2 + (int)round(wrapDelta(c.x - vw.camX, worldW));
+                    int ay = vw.top + vw.h/2 + (int)round(wrapDelta(c.y - vw.camY, worldH));
+                    for (int ry = 0; ry < sp.h; ++ry) {
+                        int sy = ay - sp.cy + ry;
+                        if (sy < vw.top || sy >= vw.top + vw.h) continue;
+                        for (int rx = 0; rx < sp.w && sp.rows[ry][rx]; ++rx) {
+                            int sx = ax - sp.cx + rx;
+                            if (sp.rows[ry][rx] == ' ' || sx < vw.left || sx >= vw.left + vw.w) continue;
+                            mvaddch(sy, sx, sp.rows[ry][rx]);
+                        }
+                    }
+                });
         }
+        if (has_colors()) attroff(COLOR_PAIR(3));
     }
 
+    // particulas (solo las toca este hilo): debajo de balas y naves
+    particles.forEach([&](float x, float y, char glyph, ParticleKind kind) {
+        Vec2 p;
+        p.x = x;
+        p.y = y;
+        int pair = (kind == PK_SHIP1) ? 1 : (kind == PK_SHIP2) ? 2 : 4;
+        for (int v = 0; v < nViews; ++v) {
+            int px, py;
+            if (!worldToScreen(views[v], p, px, py)) continue;
+            if (has_colors()) attron(COLOR_PAIR(pair));
+            mvaddch(py, px, glyph);
+            if (has_colors()) attroff(COLOR_PAIR(pair));
+        }
+    });
+
     // balas
     {
         std::lock_guard<std::mutex> lock(mtxBullets);
         for (auto &b : bullets) {
-            int bx = (int)round(b.pos.x);
-            int by = (int)round(b.pos.y);
-            if (bx >= 0 && bx < maxx && by >= 1 && by < maxy-1) {
+            Vec2 p = interpPos(b.prev, b.pos, bulAlpha);
+            for (int v = 0; v < nViews; ++v) {
+                int bx, by;
+                if (!worldToScreen(views[v], p, bx, by)) continue;
                 if (has_colors()) {
                     if (b.owner == 1) attron(COLOR_PAIR(1));
                     else if (b.owner == 2) attron(COLOR_PAIR(2));
@@ -685,41 +1414,160 @@ void Game::drawAll() {
     {
         std::lock_guard<std::mutex> lock(mtxShips);
         
-        int sx = (int)round(player.pos.x);
-        int sy = (int)round(player.pos.y);
-        if (sx >= 0 && sx < maxx && sy >= 1 && sy < maxy-1) {
-            if (has_colors()) attron(COLOR_PAIR(1) | A_BOLD);
-            mvaddch(sy, sx, player.glyph());
-            if (has_colors()) attroff(COLOR_PAIR(1) | A_BOLD);
-        }
-
-        if (mode == 3) {
-            int s2x = (int)round(player2.pos.x);
-            int s2y = (int)round(player2.pos.y);
-            if (s2x >= 0 && s2x < maxx && s2y >= 1 && s2y < maxy-1) {
+        Vec2 p1 = interpPos(player.prev, player.pos, shipAlpha);
+        Vec2 p2 = interpPos(player2.prev, player2.pos, shipAlpha);
+        for (int v = 0; v < nViews; ++v) {
+            int sx, sy;
+            if (worldToScreen(views[v], p1, sx, sy)) {
+                if (has_colors()) attron(COLOR_PAIR(1) | A_BOLD);
+                mvaddch(sy, sx, player.glyph());
+                if (has_colors()) attroff(COLOR_PAIR(1) | A_BOLD);
+            }
+
+            if (mode == 3 && worldToScreen(views[v], p2, sx, sy)) {
                 if (has_colors()) attron(COLOR_PAIR(2) | A_BOLD);
-                mvaddch(s2y, s2x, player2.glyph());
+                mvaddch(sy, sx, player2.glyph());
                 if (has_colors()) attroff(COLOR_PAIR(2) | A_BOLD);
             }
         }
     }
 
+    // pantalla dividida: separador entre las dos vistas
+    if (nViews == 2) {
+        mvvline(views[1].top, views[1].left - 1, '|', views[1].h);
+    }
+
     // controles
     if (mode != 3) {
         mvprintw(maxy-1, 2, "A/D=girar W=impulso SPACE=disparo P=pausa Q=menu");
+    } else if (lockstep) {
+        mvprintw(maxy-1, 2, "Eres P%d: A/D o flechas=girar W=impulso SPACE=disparo P=pausa Q=salir",
+                 net.role == NET_HOST ? 1 : 2);
     } else {
         mvprintw(maxy-1, 2, "P1:A/D/W/SPACE P2: flechas/ENTER P=pausa Q=menu");
     }
 
+    // estado del control de carga (sim/dibujo en % del presupuesto), a la derecha de los controles
+    int used = getcurx(stdscr);
+    {
+        char load[48];
+        static const char* LEVEL_NAMES[] = { "", " dibujo/2", " dibujo/2 pasos x2", " dibujo/2 pasos x2 oleadas/2" };
+        int lvl = budget.level();
+        int n = snprintf(load, sizeof(load), "sim %d%% dib %d%%%s",
+                         budget.tickLoad(), budget.frameLoad(), LEVEL_NAMES[lvl]);
+        if (n < (int)sizeof(load) && maxx - n - 2 > used) {
+            if (lvl > 0) attron(A_BOLD);
+            mvprintw(maxy-1, maxx - n - 2, "%s", load);
+            if (lvl > 0) attroff(A_BOLD);
+        }
+    }
+
     refresh();
 }
 
+// copia lo que quedo en pantalla al buffer de espectadores (sin IO: el envio es de otro hilo)
+void Game::captureSpectatorFrame() {
+    std::vector<uint16_t>& cells = spectators.captureBuffer();
+    cells.resize((size_t)maxx * maxy);
+    std::vector<chtype> row(maxx + 1);
+    for (int y = 0; y < maxy; ++y) {
+        int n = mvwinchnstr(stdscr, y, 0, row.data(), maxx);
+        for (int x = 0; x < maxx; ++x) {
+            chtype c = (x < n) ? row[x] : ' ';
+            uint16_t cell = (uint16_t)(c & A_CHARTEXT & CELL_CHAR);
+            cell |= (uint16_t)((PAIR_NUMBER(c & A_COLOR) << 8) & CELL_PAIR);
+            if (c & A_BOLD) cell |= CELL_BOLD;
+            if (c & A_REVERSE) cell |= CELL_REVERSE;
+            cells[(size_t)y * maxx + x] = cell;
+        }
+    }
+    spectators.publish(maxx, maxy);
+}
+
+// camara: sigue a la nave; en modo 3 se centra entre las dos si caben juntas
+// y si no, divide la pantalla en dos vistas (izquierda P1, derecha P2)
+int Game::setupViewports(Viewport views[2], double shipAlpha) {
+    Vec2 c1, c2;
+    {
+        std::lock_guard<std::mutex> lock(mtxShips);
+        c1 = interpPos(player.prev, player.pos, shipAlpha);
+        c2 = interpPos(player2.prev, player2.pos, shipAlpha);
+    }
+    int top = 1;
+    int h = maxy - 2;
+
+    if (mode != 3) {
+        views[0] = { 0, top, maxx, h, c1.x, c1.y };
+        return 1;
+    }
+    if (lockstep) {
+        // cada proceso tiene su pantalla: se sigue a la nave local
+        Vec2 c = (net.role == NET_JOIN) ? c2 : c1;
+        views[0] = { 0, top, maxx, h, c.x, c.y };
+        return 1;
+    }
+
+    double dx = wrapDelta(c2.x - c1.x, worldW);
+    double dy = wrapDelta(c2.y - c1.y, worldH);
+    if (fabs(dx) < maxx * 0.8 && fabs(dy) < h * 0.8) {
+        Vec2 mid;
+        mid.x = c1.x + dx / 2;
+        mid.y = c1.y + dy / 2;
+        wrapPosition(mid, worldW, worldH);
+        views[0] = { 0, top, maxx, h, mid.x, mid.y };
+        return 1;
+    }
+
+    int half = (maxx - 1) / 2;
+    views[0] = { 0, top, half, h, c1.x, c1.y };
+    views[1] = { half + 1, top, maxx - half - 1, h, c2.x, c2.y };
+    return 2;
+}
+
+// posicion de mundo -> celda de pantalla dentro de la vista; false si queda fuera
+bool Game::worldToScreen(const Viewport& v, const Vec2& p, int& sx, int& sy) {
+    sx = v.left + v.w/2 + (int)round(wrapDelta(p.x - v.camX, worldW));
+    sy = v.top + v.h/2 + (int)round(wrapDelta(p.y - v.camY, worldH));
+    return sx >= v.left && sx < v.left + v.w && sy >= v.top && sy < v.top + v.h;
+}
+
+// fraccion del tick actual ya transcurrida, en [0, 1]
+double Game::tickAlpha(int64_t sinceNs, int periodUs) {
+    double a = (double)sinceNs / (periodUs * 1000.0);
+    return std::max(0.0, std::min(1.0, a));
+}
+
+// interpola entre dos estados; si el salto es mayor a medio mundo la entidad cruzo el borde,
+// asi que se interpola por el lado corto y se vuelve a envolver
+Vec2 Game::interpPos(const Vec2& prev, const Vec2& cur, double alpha) {
+    Vec2 p;
+    p.x = prev.x + wrapDelta(cur.x - prev.x, worldW) * alpha;
+    p.y = prev.y + wrapDelta(cur.y - prev.y, worldH) * alpha;
+    wrapPosition(p, worldW, worldH);
+    return p;
+}
+
 double Game::dist(double x1, double y1, double x2, double y2) {
     double dx = x2 - x1;
     double dy = y2 - y1;
     return sqrt(dx*dx + dy*dy);
 }
 
+// prueba segmento a-b contra circulo (c, r): punto del segmento mas cercano al centro
+bool Game::segmentHitsCircle(const Vec2& a, const Vec2& b, const Vec2& c, double r) {
+    double abx = b.x - a.x;
+    double aby = b.y - a.y;
+    double len2 = abx*abx + aby*aby;
+    double t = 0.0;
+    if (len2 > 0.0) {
+        t = ((c.x - a.x)*abx + (c.y - a.y)*aby) / len2;
+        t = std::max(0.0, std::min(1.0, t));
+    }
+    double px = a.x + abx*t - c.x;
+    double py = a.y + aby*t - c.y;
+    return px*px + py*py <= r*r;
+}
+
 void Game::showInstructions() {
     std::lock_guard<std::mutex> lock(mtxNcurses);
     clear();
@@ -754,22 +1602,29 @@ void Game::showScores() {
     mvprintw(2, 2, "PUNTAJES GUARDADOS");
     mvprintw(4, 2, "===================");
     
-    std::ifstream ifs("scores.txt");
-    if (!ifs.is_open()) {
+    leaderboard.refresh(); // ver lo que compactaron este u otros kioscos
+    if (!leaderboard.isOpen()) {
+        mvprintw(6, 2, "No se pudo abrir scores.idx / scores.log");
+    } else if (leaderboard.totalGames() == 0) {
         mvprintw(6, 2, "No hay puntajes guardados todavia");
         mvprintw(8, 2, "Juega una partida para guardar tu puntaje");
     } else {
-        std::string line;
-        int row = 6;
-        while (std::getline(ifs, line) && row < maxy - 4) {
-            mvprintw(row, 4, "%s", line.c_str());
-            row++;
-        }
-        ifs.close();
-        
-        if (row == 6) {
-            mvprintw(6, 2, "El archivo esta vacio. Juega para guardar puntajes");
+        // una columna por modo, solo el top que cabe en pantalla
+        // fila = "NN. " + nombre + " " + puntaje de 6 + separacion: el nombre se recorta a lo que
+        // deja el ancho de la columna (20 como mucho, 4 como poco)
+        int rows = std::max(maxy - 11, 1);
+        int colW = (maxx - 2) / 3;
+        int nameW = std::max(4, std::min(20, colW - 12));
+        colW = std::max(colW, nameW + 12);
+        for (int m = 1; m <= 3; ++m) {
+            int x = 2 + (m-1) * colW;
+            mvprintw(6, x, "Modo %d", m);
+            std::vector<ScoreRecord> top = leaderboard.top(m, rows);
+            for (int i = 0; i < (int)top.size(); ++i) {
+                mvprintw(8 + i, x, "%2d. %-*.*s %6d", i+1, nameW, nameW, top[i].name, top[i].score);
+            }
         }
+        mvprintw(maxy-3, 2, "Partidas registradas: %llu", (unsigned long long)leaderboard.totalGames());
     }
     
     mvprintw(maxy-2, 2, "Presiona cualquier tecla para volver.");
@@ -779,6 +1634,29 @@ void Game::showScores() {
     nodelay(stdscr, TRUE);
 }
 
+int Game::waitKey() {
+    return soak.active() ? ' ' : getch();
+}
+
+void Game::readName(char* buf, int n) {
+    if (soak.active()) snprintf(buf, n, "soak-bot");
+    else getnstr(buf, n);
+}
+
+// una linea por partida en debug.log: RSS, hilos y descriptores ya de vuelta en el menu
+bool Game::soakAfterMatch() {
+    size_t cap = asteroids.capacity() + bullets.capacity() + bulletScratch.capacity() + tickEvents.capacity();
+    long scores = 0;
+    for (const char* ext : { ".idx", ".log", ".journal" }) {
+        struct stat st;
+        if (stat((scoresPath + ext).c_str(), &st) == 0) scores += (long)st.st_size;
+    }
+    FILE* f = fopen(logPath.c_str(), "a");
+    bool more = soak.afterMatch(f, cap, scores);
+    if (f) fclose(f);
+    return more;
+}
+
 void Game::saveScoresAfterGame(bool twoPlayers) {
     nodelay(stdscr, FALSE);
     timeout(-1);
@@ -786,60 +1664,61 @@ void Game::saveScoresAfterGame(bool twoPlayers) {
     curs_set(1);
 
     char namebuf[64];
-    std::ofstream ofs("scores.txt", std::ios::app);
 
-    if (!ofs.is_open()) {
-        mvprintw(maxy-3, 2, "ERROR: No se pudo abrir scores.txt para guardar.");
+    if (!leaderboard.isOpen() || !scoreWriter.isRunning()) {
+        mvprintw(maxy-3, 2, "ERROR: No se pudo abrir scores.idx / scores.journal para guardar.");
         mvprintw(maxy-2, 2, "Presiona una tecla para continuar...");
         refresh();
         flushinp();
-        getch();
+        waitKey();
     } else {
         if (!twoPlayers) {
             // === MODO 1 o 2 ===
             mvprintw(maxy-4, 2, "Ingresa tu nombre (max 20 caracteres): ");
             move(maxy-4, 44);
             memset(namebuf, 0, sizeof(namebuf));
-            getnstr(namebuf, 20);
+            readName(namebuf, 20);
 
             std::string name(namebuf);
             if (name.empty()) name = "Anonimo";
 
-            ofs << name << " - " << player.score.load() << std::endl;
-            ofs.flush(); // asegura que se escriba ya
+            int score = lockstep ? localShip().score.load() : player.score.load();
+            scoreWriter.submit(name, score, mode);
 
-            mvprintw(maxy-3, 2, "Puntaje guardado: %s - %d", name.c_str(), player.score.load());
+            // el registro recien encolado todavia no esta en el indice
+            int best = 0;
+            leaderboard.playerBest(name, mode, best);
+            best = std::max(best, score);
+            mvprintw(maxy-3, 2, "Puntaje guardado: %s - %d (mejor: %d)", name.c_str(), score, best);
             mvprintw(maxy-2, 2, "Presiona una tecla para volver al menu...");
             refresh();
             flushinp();
-            getch();
+            waitKey();
         } else {
             // === MODO 3 (dos jugadores) ===
             mvprintw(maxy-6, 2, "Nombre Jugador 1 (max 20 caracteres): ");
             move(maxy-6, 43);
             memset(namebuf, 0, sizeof(namebuf));
-            getnstr(namebuf, 20);
+            readName(namebuf, 20);
             std::string n1(namebuf);
             if (n1.empty()) n1 = "P1";
 
             mvprintw(maxy-5, 2, "Nombre Jugador 2 (max 20 caracteres): ");
             move(maxy-5, 43);
             memset(namebuf, 0, sizeof(namebuf));
-            getnstr(namebuf, 20);
+            readName(namebuf, 20);
             std::string n2(namebuf);
             if (n2.empty()) n2 = "P2";
 
-            ofs << n1 << " - " << player.score.load() << std::endl;
-            ofs << n2 << " - " << player2.score.load() << std::endl;
-            ofs.flush();
+            scoreWriter.submit(n1, player.score.load(), mode);
+            scoreWriter.submit(n2, player2.score.load(), mode);
 
             mvprintw(maxy-3, 2, "Puntajes guardados ");
             mvprintw(maxy-2, 2, "Presiona una tecla para volver al menu...");
             refresh();
             flushinp();
-            getch();
+            waitKey();
         }
-        ofs.close();
     }
 
     noecho();
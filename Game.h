@@ -7,18 +7,56 @@
 #include <mutex>
 #include <condition_variable>
 #include <atomic>
+#include <cstdint>
 #include "Ship.h"
 #include "Asteroid.h"
 #include "Projectile.h"
+#include "Leaderboard.h"
+#include "ScoreWriter.h"
+#include "Broadphase.h"
+#include "WaveGenerator.h"
+#include "Script.h"
+#include "Lockstep.h"
+#include "Rng.h"
+#include "Spectator.h"
+#include "Snapshot.h"
+#include "ThreadConfig.h"
+#include "Latency.h"
+#include "TaskGraph.h"
+#include "GameEvents.h"
+#include "Particles.h"
+#include "FrameBudget.h"
+#include "Soak.h"
+
+// eventos que pueden esperar los scripts (Scheduler::event)
+enum ScriptEvent {
+    SEVT_WAVE_CLEARED = 1,
+    SEVT_SHIP_LOST = 2
+};
+
+// region del mundo que se muestra en una parte de la pantalla
+struct Viewport {
+    int left, top, w, h;   // rectangulo en pantalla
+    double camX, camY;     // centro de la camara en coordenadas de mundo
+};
 
 // esta clase maneja el juego con hilos POSIX (fase 3)
-// arquitectura: 5 hilos principales + 5 auxiliares = 10 total
+// arquitectura: input, update, dibujo y HUD + un pool de trabajadores que ejecuta
+// el grafo de tareas de cada tick (naves, asteroides, balas, colisiones, reglas)
 class Game {
 public:
     Game();
     ~Game();
 
     void run(); // loop principal del juego y manejo de menú
+    // partida en red local: host crea el socket en path, join se conecta (una partida y sale)
+    void setNetwork(NetRole role, const std::string& path);
+    // publica las partidas para espectadores (--watch path) en este socket
+    void setSpectatorSocket(const std::string& path);
+    // --soak: un bot juega matches partidas seguidas; soakFailed si se paso algun limite.
+    // false si no se pudo crear su directorio temporal
+    bool setSoak(int matches);
+    bool soakFailed() const { return soak.failed(); }
 
     // banderas globales (atomic para thread-safety sin mutex)
     std::atomic<bool> quitFlag;
@@ -27,6 +65,7 @@ public:
     std::atomic<bool> returnToMenu;
     
     int maxx, maxy; // tamaño pantalla
+    int worldW, worldH; // tamaño del mundo (varias pantallas, se envuelve en los bordes)
     int mode; // 1,2,3
     int winScore;
 
@@ -36,6 +75,81 @@ public:
     std::vector<Asteroid> asteroids;
     std::vector<Projectile> bullets;
 
+    // tabla de puntajes persistente (scores.idx + scores.log)
+    Leaderboard leaderboard;
+    // guarda los puntajes en segundo plano (journal + compactacion)
+    ScoreWriter scoreWriter;
+
+    // momento (ns, steady_clock) en que termino el ultimo tick de cada grupo;
+    // el dibujo interpola entre prev y pos segun el tiempo transcurrido desde entonces
+    std::atomic<int64_t> asteroidTickNs;
+    std::atomic<int64_t> bulletTickNs;
+    std::atomic<int64_t> shipTickNs;
+
+    // broad-phase asteroide vs asteroide (se conserva entre ticks)
+    SweepAndPrune asteroidSap;
+    std::vector<std::pair<int,int>> asteroidPairs;
+    // indice espacial de asteroides para dibujar solo lo que ve la camara
+    SpatialGrid asteroidGrid;
+    unsigned asteroidTick;
+
+    // siguiente oleada, generada en segundo plano
+    WaveGenerator waveGen;
+
+    // etapas del tick y el pool que las ejecuta (lo maneja updateThread)
+    TaskGraph tickGraph;
+    TaskPool tickPool;
+
+    // eventos del tick: los genera la deteccion de colisiones, los aplica applyEvents
+    // y despues los reciben los oyentes (HUD, estadisticas, log de eventos)
+    std::vector<GameEvent> tickEvents;
+    EventBus events;
+    EventStats stats;       // solo el oyente de estadisticas (y el reporte tras el join)
+    FILE* eventLogFile;     // solo el oyente del log
+    std::vector<Projectile> bulletScratch; // copia de las balas para detectar sin lock
+    std::vector<uint8_t> astFlags, bulFlags;
+
+    // scripts (corrutinas) reanudados en cada tick de updateThread
+    Scheduler scripts;
+    std::string hudMessage; // protegido por mtxGameState
+
+    // azar de la simulacion (protegido por mtxAsteroids); en red ambos procesos usan la misma semilla
+    Rng rng;
+
+    // multijugador en lockstep: con lockstep activo updateThread simula todo por tick
+    // y los hilos auxiliares no corren
+    Lockstep net;
+    std::string netPath;
+    bool lockstep;
+    std::atomic<uint8_t> netKeys; // teclas locales (InputBits) acumuladas desde el ultimo tick
+    std::atomic<int64_t> netKeysNs; // lectura de la tecla mas vieja en netKeys (0 = ninguna)
+    std::string netError;         // motivo de fin anormal (desync, desconexion)
+
+    // transmision a espectadores (la captura la hace drawThread)
+    SpectatorServer spectators;
+    std::string spectatorPath;
+
+    // checkpoint periodico de la partida (savegame.snap) para retomarla tras un cierre
+    SnapshotWriter checkpoints;
+    std::string checkpointBuf; // solo hudUpdateThread / fin de partida
+    std::string scoresPath, checkpointPath; // con --soak van a soakDir
+    std::string logPath; // reportes por partida (debug.log); con --soak tambien en soakDir
+
+    // afinidad/prioridad de los hilos (asteroids.conf) y variacion del periodo de cada grupo
+    RuntimeConfig config;
+    std::mutex mtxTuning;
+    std::string tuningErrors; // protegido por mtxTuning
+    JitterStats jitterSim, jitterRender, jitterInput;
+    // latencia tecla -> cuadro en pantalla
+    LatencyProbe inputLatency;
+    ParticlePool particles; // efectos: los pide cualquier hilo, los avanza y dibuja drawThread
+    FrameBudget budget;
+    std::atomic<int> tickSteps; // periodos de SIM_TICK_US que cubre cada tick (2 = pasos juntados)
+    // prueba larga: el bot reemplaza al teclado, el monitor mide entre partidas
+    SoakMonitor soak;
+    SoakBot bot;
+    std::string soakDir; // temporal; queda al salir con el debug.log del soak
+
     // mutex globales para proteger acceso a objetos compartidos
     std::mutex mtxShips;
     std::mutex mtxAsteroids;
@@ -55,50 +169,70 @@ private:
     void mainMenu();
     void showInstructions();
     void showScores(); 
-    void startGame();
-    void spawnInitialAsteroids();
+    void startGame(bool resume = false);
+    void spawnInitialAsteroids(); // requiere mtxAsteroids tomado
+    int waveSize() const;
+    void requestNextWave();       // requiere mtxShips tomado
     void saveScoresAfterGame(bool twoPlayers);
+    int waitKey();                      // pantallas bloqueantes (con --soak no espera)
+    void readName(char* buf, int n);
+    bool soakAfterMatch();
     void resetGame();
     void checkWinLoseConditions();
+    bool matchOver() const;
+    void captureCheckpoint(std::string& buf);
+    void tuneThread(const char* name, ThreadGroup group);
+    void writeJitterReport();
+    void writeLatencyReport();
+    bool restoreCheckpoint();
     void showEndGameScreen();
+    bool connectPeer();
+    void buildTickGraph();
+    void lockstepLoop();
+    uint32_t stateChecksum();
+    Ship& localShip();
 
-    // === HILOS PRINCIPALES (5) ===
-    // hilo 1: captura input del usuario
+    // === HILOS DE LA PARTIDA ===
+    // captura input del usuario
     static void* inputThread(void* arg);
     
-    // hilo 2: actualiza física del juego
+    // avanza la simulacion: ejecuta tickGraph cada SIM_TICK_US (o lockstepLoop en red)
     static void* updateThread(void* arg);
     
-    // hilo 3: detecta colisiones
-    static void* collisionThread(void* arg);
-    
-    // hilo 4: renderiza todo en pantalla
+    // renderiza todo en pantalla
     static void* drawThread(void* arg);
     
-    // hilo 5: controla lógica de ganar/perder
-    static void* gameLogicThread(void* arg);
-
-    // === HILOS AUXILIARES (5) ===
-    // hilo 6: actualiza asteroides específicamente
-    static void* asteroidUpdateThread(void* arg);
-    
-    // hilo 7: actualiza proyectiles específicamente
-    static void* projectileUpdateThread(void* arg);
-    
-    // hilo 8: actualiza nave 1
-    static void* ship1UpdateThread(void* arg);
-    
-    // hilo 9: actualiza nave 2 (solo en modo 3)
-    static void* ship2UpdateThread(void* arg);
-    
-    // hilo 10: actualiza HUD y stats
+    // HUD y checkpoints periodicos
     static void* hudUpdateThread(void* arg);
 
+    // scripts de la partida
+    Script reinforcementScript();
+    Script bannerScript(int event, const char* text);
+
     // helpers internos
     void handleInput(int ch);
+    uint8_t keyBits(int ch);
+    void fireBullet(const Ship& s, int owner); // requiere mtxBullets
+    void thrustTrail(const Ship& s, int owner);
+    void applyKeys(Ship& s, uint8_t keys, int owner); // requiere mtxShips y mtxBullets
+    void stepAsteroids(const Vec2& s1, const Vec2& s2, int steps); // requiere mtxAsteroids
+    void stepBullets(double dt, int steps); // requiere mtxBullets
     double dist(double x1, double y1, double x2, double y2);
-    void tryCollisions();
+    bool segmentHitsCircle(const Vec2& a, const Vec2& b, const Vec2& c, double r);
+    void detectCollisions(std::vector<GameEvent>& out);
+    void applyEvents(std::vector<GameEvent>& ev); // requiere los 3 mutex de entidades
+    void subscribeListeners();
+    void writeStatsReport();
+    void resolveAsteroidCollisions();
+    void splitAsteroid(const Asteroid& a, std::vector<Asteroid>& out);
+    bool bulletHitsAsteroid(const Vec2& from, const Vec2& to, const Asteroid& a);
+    bool shipHitsAsteroid(const Vec2& ship, const Asteroid& a);
     void drawAll();
+    void captureSpectatorFrame(); // requiere mtxNcurses
+    double tickAlpha(int64_t sinceNs, int periodUs);
+    Vec2 interpPos(const Vec2& prev, const Vec2& cur, double alpha);
+    int setupViewports(Viewport views[2], double shipAlpha);
+    bool worldToScreen(const Viewport& v, const Vec2& p, int& sx, int& sy);
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,85 @@
+#ifndef GAMEEVENTS_H
+#define GAMEEVENTS_H
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// lo que paso en un tick, como registros chicos en vez de cambios directos al estado.
+// la deteccion de colisiones solo agrega eventos; despues cada consumidor (estado, HUD,
+// estadisticas, log de eventos) recorre el buffer por su cuenta
+
+enum GameEventType : uint8_t {
+    EV_BULLET_HIT = 1,     // bala b destruyo al asteroide a (lo detecta la colision)
+    EV_SHIP_DESTROYED = 2, // la nave de player choco con el asteroide a (idem)
+    EV_SCORE = 3,          // player suma value puntos (idem)
+    EV_ASTEROID_SPLIT = 4, // el asteroide de tamaño size se partio en dos (lo agrega el estado)
+    EV_WAVE_CLEARED = 5    // no quedaban asteroides y entro una oleada nueva (idem)
+};
+
+struct GameEvent {
+    uint8_t type;
+    uint8_t player; // 1, 2 o 0 si no aplica
+    uint8_t size;   // tamaño del asteroide involucrado
+    uint8_t pad;
+    int32_t a;      // indice de asteroide (antes de aplicar el tick)
+    int32_t b;      // indice de bala / puntos
+    float x, y;     // donde ocurrio (efectos)
+};
+
+static_assert(sizeof(GameEvent) == 20, "GameEvent es un registro fijo (log de eventos)");
+
+inline GameEvent makeEvent(GameEventType type, int player, int size, int a, int b, double x, double y) {
+    GameEvent e;
+    e.type = type;
+    e.player = (uint8_t)player;
+    e.size = (uint8_t)size;
+    e.pad = 0;
+    e.a = a;
+    e.b = b;
+    e.x = (float)x;
+    e.y = (float)y;
+    return e;
+}
+
+// contadores de la partida (consumidor de estadisticas)
+struct EventStats {
+    uint32_t destroyed[4];  // asteroides destruidos por tamaño (bala o choque)
+    uint32_t shipsLost[3];  // por jugador
+    uint32_t points[3];
+    uint32_t splits;
+    uint32_t waves;
+
+    void reset() { *this = EventStats(); }
+    void add(const std::vector<GameEvent>& events) {
+        for (auto &e : events) {
+            int p = e.player <= 2 ? e.player : 0;
+            int s = e.size <= 3 ? e.size : 0;
+            switch (e.type) {
+            case EV_BULLET_HIT: destroyed[s]++; break;
+            case EV_SHIP_DESTROYED: shipsLost[p]++; destroyed[s]++; break;
+            case EV_SCORE: points[p] += e.b; break;
+            case EV_ASTEROID_SPLIT: splits++; break;
+            case EV_WAVE_CLEARED: waves++; break;
+            }
+        }
+    }
+};
+
+// oyentes que no modifican el estado; corren despues de aplicar los eventos, fuera del
+// loop de colisiones, asi que agregar uno no encarece la deteccion
+class EventBus {
+public:
+    typedef std::function<void(const std::vector<GameEvent>&, uint32_t tick)> Listener;
+
+    void subscribe(Listener l) { listeners.push_back(std::move(l)); }
+    void dispatch(const std::vector<GameEvent>& events, uint32_t tick) const {
+        if (events.empty()) return;
+        for (auto &l : listeners) l(events, tick);
+    }
+
+private:
+    std::vector<Listener> listeners;
+};
+
+#endif
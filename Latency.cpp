@@ -0,0 +1,81 @@
+#include "Latency.h"
+#include <cstring>
+
+void LatencyProbe::reset() {
+    std::lock_guard<std::mutex> lock(mtx);
+    pendRead = pendApplied = 0;
+    frameRead = frameApplied = frameStart = 0;
+    memset(hist, 0, sizeof(hist));
+    n = 0;
+    sumApplyNs = sumWaitNs = sumRenderNs = 0.0;
+    maxNs = 0;
+}
+
+void LatencyProbe::inputApplied(int64_t readNs, int64_t appliedNs) {
+    std::lock_guard<std::mutex> lock(mtx);
+    if (pendRead != 0) return; // ya hay una mas vieja esperando cuadro
+    pendRead = readNs;
+    pendApplied = appliedNs;
+}
+
+void LatencyProbe::frameBegin(int64_t nowNs) {
+    if (frameRead != 0) return; // el cuadro anterior no llego a mostrarse
+    std::lock_guard<std::mutex> lock(mtx);
+    if (pendRead == 0) return;
+    frameRead = pendRead;
+    frameApplied = pendApplied;
+    frameStart = nowNs;
+    pendRead = pendApplied = 0;
+}
+
+void LatencyProbe::frameShown(int64_t nowNs) {
+    if (frameRead == 0) return;
+    int64_t total = nowNs - frameRead;
+    int b = (int)(total / 1000000);
+    hist[b < BUCKETS ? b : BUCKETS]++;
+    n++;
+    sumApplyNs += frameApplied - frameRead;
+    sumWaitNs += frameStart - frameApplied;
+    sumRenderNs += nowNs - frameStart;
+    if (total > maxNs) maxNs = total;
+    frameRead = 0;
+}
+
+double LatencyProbe::percentileMs(double p) const {
+    if (n == 0) return 0.0;
+    uint64_t want = (uint64_t)(p * n);
+    if (want >= n) want = n - 1;
+    uint64_t acc = 0;
+    for (int b = 0; b <= BUCKETS; ++b) {
+        acc += hist[b];
+        if (acc > want) return b + 1.0; // borde superior del bucket
+    }
+    return BUCKETS + 1.0;
+}
+
+void LatencyProbe::report(FILE* f, int targetMs) const {
+    if (n == 0) {
+        fprintf(f, "  latencia: sin teclas medidas\n");
+        return;
+    }
+    uint64_t within = 0;
+    for (int b = 0; b < targetMs && b < BUCKETS; ++b) within += hist[b];
+    fprintf(f, "  latencia n=%llu p50<=%.0fms p90<=%.0fms p99<=%.0fms max=%.1fms | meta %dms: %.1f%% %s\n",
+            (unsigned long long)n, percentileMs(0.50), percentileMs(0.90), percentileMs(0.99),
+            maxNs / 1e6, targetMs, 100.0 * within / n,
+            percentileMs(0.99) <= targetMs ? "OK" : "FUERA DE META");
+    fprintf(f, "  etapas (media): aplicar=%.2fms esperar cuadro=%.2fms dibujar+refresh=%.2fms\n",
+            sumApplyNs / n / 1e6, sumWaitNs / n / 1e6, sumRenderNs / n / 1e6);
+
+    // histograma compacto: solo buckets con muestras, barra proporcional
+    uint64_t peak = 0;
+    for (int b = 0; b <= BUCKETS; ++b) if (hist[b] > peak) peak = hist[b];
+    for (int b = 0; b <= BUCKETS; ++b) {
+        if (!hist[b]) continue;
+        int bar = (int)(40 * hist[b] / peak);
+        if (b < BUCKETS) fprintf(f, "  %3d-%3dms %6llu ", b, b + 1, (unsigned long long)hist[b]);
+        else fprintf(f, "  >=%3dms   %6llu ", BUCKETS, (unsigned long long)hist[b]);
+        for (int i = 0; i < bar; ++i) fputc('#', f);
+        fputc('\n', f);
+    }
+}
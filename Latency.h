@@ -0,0 +1,43 @@
+#ifndef LATENCY_H
+#define LATENCY_H
+
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+
+// latencia de entrada a pantalla: desde que inputThread lee la tecla hasta que termina el
+// refresh() del primer cuadro dibujado despues de aplicarla.
+// si llegan varias teclas antes de un cuadro se mide la mas vieja (el peor caso).
+// no incluye el tiempo que la tecla espero en el buffer de la terminal antes del getch()
+// (hasta un periodo de sondeo de inputThread)
+class LatencyProbe {
+public:
+    static const int BUCKETS = 100; // de 1 ms; el ultimo junta todo lo que pasa de 100 ms
+
+    LatencyProbe() { reset(); }
+    void reset();
+
+    // la tecla leida en readNs ya modifico el estado (appliedNs)
+    void inputApplied(int64_t readNs, int64_t appliedNs);
+    // drawThread: antes de leer el estado para dibujar / despues de refresh()
+    void frameBegin(int64_t nowNs);
+    void frameShown(int64_t nowNs);
+
+    // solo con drawThread detenido
+    uint64_t count() const { return n; }
+    double percentileMs(double p) const;
+    void report(FILE* f, int targetMs) const;
+
+private:
+    std::mutex mtx;
+    int64_t pendRead, pendApplied; // aplicada, esperando cuadro (protegido por mtx)
+
+    // solo drawThread
+    int64_t frameRead, frameApplied, frameStart;
+    uint64_t hist[BUCKETS + 1];
+    uint64_t n;
+    double sumApplyNs, sumWaitNs, sumRenderNs;
+    int64_t maxNs;
+};
+
+#endif
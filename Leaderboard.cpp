@@ -0,0 +1,412 @@
+#include "Leaderboard.h"
+#include <algorithm>
+#include <cstring>
+#include <ctime>
+#include <memory>
+#include <sched.h>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static const uint32_t IDX_MAGIC = 0x41535442; // "ASTB"
+static const uint32_t IDX_VERSION = 1;
+static const int READ_TRIES = 100; // lecturas repetidas si otro proceso esta en medio de un commit
+
+static uint32_t nameHash(const char* name) {
+    uint32_t h = 2166136261u; // FNV-1a
+    for (int i = 0; i < 24 && name[i]; ++i) {
+        h ^= (uint8_t)name[i];
+        h *= 16777619u;
+    }
+    return h ? h : 1; // 0 se reserva para slot libre
+}
+
+static bool writeAll(int fd, const void* data, size_t len, off_t off) {
+    const char* p = (const char*)data;
+    while (len > 0) {
+        ssize_t n = pwrite(fd, p, len, off);
+        if (n <= 0) return false;
+        p += n; off += n; len -= (size_t)n;
+    }
+    return true;
+}
+
+Leaderboard::Leaderboard() : idx(nullptr), idxPlayers(nullptr), idxSize(0), idxIno(0) {}
+
+Leaderboard::~Leaderboard() {
+    close();
+}
+
+bool Leaderboard::open(const std::string& basePath) {
+    close();
+    base = basePath;
+    bool torn = false;
+    if (refresh()) {
+        std::lock_guard<std::mutex> lock(mtx);
+        torn = (__atomic_load_n(&idx->h.seq, __ATOMIC_ACQUIRE) & 1) != 0;
+        if (!torn) return true;
+    }
+    // no hay indice valido todavia, o quedo un commit cortado: crearlo o repararlo
+    // (se reconstruye desde el log si existe; si otro proceso estaba escribiendo, se espera el lock)
+    return commit({}, 0);
+}
+
+void Leaderboard::close() {
+    std::lock_guard<std::mutex> lock(mtx);
+    unmapIndex();
+}
+
+bool Leaderboard::isOpen() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return idx != nullptr;
+}
+
+void Leaderboard::unmapIndex() {
+    if (idx) {
+        munmap((void*)idx, idxSize);
+        idx = nullptr;
+        idxPlayers = nullptr;
+        idxSize = 0;
+        idxIno = 0;
+    }
+}
+
+bool Leaderboard::refresh() {
+    std::lock_guard<std::mutex> lock(mtx);
+    return mapIndex();
+}
+
+bool Leaderboard::mapIndex() {
+    struct stat st;
+    if (stat((base + ".idx").c_str(), &st) != 0) return false;
+    if (idx && st.st_ino == idxIno) return true; // sigue siendo el mismo archivo
+    if ((size_t)st.st_size < sizeof(IndexFile)) return false;
+
+    int fd = ::open((base + ".idx").c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    fstat(fd, &st); // el del archivo abierto (pudo cambiar desde el stat)
+    size_t size = (size_t)st.st_size;
+    void* p = size >= sizeof(IndexFile) ? mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+    ::close(fd);
+    if (p == MAP_FAILED) return false;
+
+    const IndexFile* f = (const IndexFile*)p;
+    uint32_t slots = f->h.playerSlots;
+    if (f->h.magic != IDX_MAGIC || f->h.version != IDX_VERSION ||
+        slots == 0 || (slots & (slots - 1)) != 0 || fileSize(slots) != size) {
+        munmap(p, size);
+        return false;
+    }
+    unmapIndex();
+    idx = f;
+    idxPlayers = (const PlayerSlot*)((const char*)p + sizeof(IndexFile));
+    idxSize = size;
+    idxIno = st.st_ino;
+    return true;
+}
+
+void Leaderboard::initIndex(IndexImage& f) {
+    memset((void*)&f.head, 0, sizeof(IndexFile));
+    f.head.h.magic = IDX_MAGIC;
+    f.head.h.version = IDX_VERSION;
+    f.head.h.playerSlots = MIN_PLAYER_SLOTS;
+    PlayerSlot empty;
+    memset(&empty, 0, sizeof(empty));
+    f.players.assign(MIN_PLAYER_SLOTS, empty);
+}
+
+// el indice publicado en disco; false si no existe o no es de esta version
+bool Leaderboard::readIndex(IndexImage& f, int fd) {
+    memset((void*)&f.head, 0, sizeof(IndexFile));
+    if (pread(fd, &f.head, sizeof(IndexFile), 0) != (ssize_t)sizeof(IndexFile)) return false;
+    const IndexHeader &h = f.head.h;
+    if (h.magic != IDX_MAGIC || h.version != IDX_VERSION || (h.seq & 1) != 0) return false;
+    if (h.playerSlots == 0 || (h.playerSlots & (h.playerSlots - 1)) != 0) return false;
+    f.players.resize(h.playerSlots);
+    size_t len = (size_t)h.playerSlots * sizeof(PlayerSlot);
+    return pread(fd, f.players.data(), len, sizeof(IndexFile)) == (ssize_t)len;
+}
+
+bool Leaderboard::rebuildFromLog(IndexImage& f, int logFd) {
+    uint32_t gen = f.head.h.journalGen;
+    initIndex(f);
+    f.head.h.journalGen = gen;
+
+    struct stat st;
+    if (fstat(logFd, &st) != 0) return false;
+    // descartar un registro incompleto al final (escritura cortada)
+    off_t whole = st.st_size - st.st_size % (off_t)sizeof(ScoreRecord);
+    if (whole != st.st_size && ftruncate(logFd, whole) != 0) return false;
+
+    ScoreRecord buf[256];
+    off_t off = 0;
+    while (off < whole) {
+        ssize_t n = pread(logFd, buf, sizeof(buf), off);
+        if (n <= 0) return false;
+        size_t count = (size_t)n / sizeof(ScoreRecord);
+        for (size_t i = 0; i < count; ++i) applyRecord(f, buf[i]);
+        off += (off_t)(count * sizeof(ScoreRecord));
+    }
+    return true;
+}
+
+// sondeo lineal: el slot del jugador o el libre donde iria
+int Leaderboard::findPlayer(const PlayerSlot* slots, uint32_t n, const char* name, uint32_t h) {
+    uint32_t mask = n - 1;
+    for (uint32_t i = 0; i < n; ++i) {
+        uint32_t at = (h + i) & mask;
+        const PlayerSlot& s = slots[at];
+        if (s.hash == 0) return (int)at;
+        if (s.hash == h && strncmp(s.name, name, sizeof(s.name)) == 0) return (int)at;
+    }
+    return -1;
+}
+
+// tabla al 75%: se duplica y se reubica todo (solo en commit, el indice publicado no cambia)
+void Leaderboard::growPlayers(IndexImage& f) {
+    std::vector<PlayerSlot> old;
+    old.swap(f.players);
+    uint32_t n = (uint32_t)old.size() * 2;
+    PlayerSlot empty;
+    memset(&empty, 0, sizeof(empty));
+    f.players.assign(n, empty);
+    for (const PlayerSlot& s : old) {
+        if (s.hash == 0) continue;
+        f.players[findPlayer(f.players.data(), n, s.name, s.hash)] = s;
+    }
+    f.head.h.playerSlots = n;
+}
+
+// commit completo: la tabla crece antes de pasar del 75%
+void Leaderboard::applyRecord(IndexImage& img, const ScoreRecord& r) {
+    if (img.head.h.playerCount + 1 > img.head.h.playerSlots / 4 * 3) growPlayers(img);
+    applyRecord(img.head, img.players.data(), r);
+}
+
+void Leaderboard::applyRecord(IndexFile& f, PlayerSlot* players, const ScoreRecord& r) {
+    if (r.mode < 1 || r.mode > MODES) return;
+    int m = r.mode - 1;
+    f.h.recordCount++;
+
+    // top-K: busqueda binaria del lugar (empates quedan detras de los anteriores)
+    ScoreRecord* first = f.top[m];
+    uint32_t& count = f.h.topCount[m];
+    ScoreRecord* pos = std::upper_bound(first, first + count, r,
+        [](const ScoreRecord& a, const ScoreRecord& b){ return a.score > b.score; });
+    int at = (int)(pos - first);
+    if (at < TOP_K) {
+        int tail = std::min((int)count, TOP_K - 1) - at;
+        if (tail > 0) memmove(pos + 1, pos, tail * sizeof(ScoreRecord));
+        *pos = r;
+        if (count < (uint32_t)TOP_K) count++;
+    }
+
+    uint32_t h = nameHash(r.name);
+    PlayerSlot& p = players[findPlayer(players, f.h.playerSlots, r.name, h)];
+    if (p.hash == 0) {
+        p.hash = h;
+        memcpy(p.name, r.name, sizeof(p.name));
+        p.name[sizeof(p.name) - 1] = '\0';
+        for (int k = 0; k < MODES; ++k) p.best[k] = -1;
+        f.h.playerCount++;
+    }
+    if (r.score > p.best[m]) p.best[m] = r.score;
+}
+
+bool Leaderboard::commit(const std::vector<ScoreRecord>& recs, uint32_t journalGen) {
+    // un solo escritor a la vez entre procesos (kioscos con el directorio compartido)
+    int lockFd = ::open((base + ".lock").c_str(), O_RDWR | O_CREAT, 0644);
+    if (lockFd < 0) return false;
+    flock(lockFd, LOCK_EX);
+
+    bool ok = false;
+    int logFd = ::open((base + ".log").c_str(), O_RDWR | O_CREAT, 0644);
+    if (logFd >= 0) {
+        // lo normal es cambiar el indice en el lugar; si no se puede, se reescribe entero
+        bool done = false;
+        int idxFd = ::open((base + ".idx").c_str(), O_RDWR);
+        if (idxFd >= 0) {
+            ok = commitInPlace(idxFd, logFd, recs, journalGen, done);
+            ::close(idxFd);
+        }
+        if (!done) ok = commitRewrite(logFd, recs, journalGen);
+        ::close(logFd);
+    }
+
+    flock(lockFd, LOCK_UN);
+    ::close(lockFd);
+
+    if (ok) refresh();
+    return ok;
+}
+
+// indice sano, log al dia y lugar en la tabla para todos los registros: se escriben solo la
+// cabecera, el top y los slots que cambian. done = false si no se cumple (y no toco nada)
+bool Leaderboard::commitInPlace(int idxFd, int logFd, const std::vector<ScoreRecord>& recs,
+                                uint32_t journalGen, bool& done) {
+    struct stat st, ls;
+    if (fstat(idxFd, &st) != 0 || (size_t)st.st_size < sizeof(IndexFile) || fstat(logFd, &ls) != 0) return false;
+    size_t size = (size_t)st.st_size;
+    void* p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, idxFd, 0);
+    if (p == MAP_FAILED) return false;
+
+    IndexFile* f = (IndexFile*)p;
+    PlayerSlot* players = (PlayerSlot*)((char*)p + sizeof(IndexFile));
+    IndexHeader& h = f->h;
+    off_t expected = (off_t)(h.recordCount * sizeof(ScoreRecord));
+    uint32_t slots = h.playerSlots;
+    bool usable = h.magic == IDX_MAGIC && h.version == IDX_VERSION && (h.seq & 1) == 0
+               && slots != 0 && (slots & (slots - 1)) == 0 && fileSize(slots) == size
+               && h.playerCount + recs.size() <= slots / 4 * 3
+               && ls.st_size >= expected;
+    if (!usable) {
+        munmap(p, size);
+        return false;
+    }
+    done = true;
+
+    bool ok = false;
+    do {
+        // el log puede traer registros de un commit que no llego a publicarse: se descartan,
+        // siguen en el journal y se vuelven a aplicar
+        if (ls.st_size > expected && ftruncate(logFd, expected) != 0) break;
+        if (recs.empty() && journalGen <= h.journalGen) { ok = true; break; }
+        if (!recs.empty()) {
+            if (!writeAll(logFd, recs.data(), recs.size() * sizeof(ScoreRecord), expected)) break;
+            if (fdatasync(logFd) != 0) break;
+        }
+
+        // secuencia impar en disco antes de tocar nada: si se corta aca, el proximo commit
+        // lo ve y reconstruye desde el log. los lectores reintentan mientras sea impar
+        __atomic_store_n(&h.seq, h.seq + 1, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_RELEASE);
+        if (fdatasync(idxFd) != 0) break;
+        for (const ScoreRecord& r : recs) applyRecord(*f, players, r);
+        if (journalGen > h.journalGen) h.journalGen = journalGen;
+        if (fdatasync(idxFd) != 0) break;
+        __atomic_store_n(&h.seq, h.seq + 1, __ATOMIC_RELEASE);
+        ok = fdatasync(idxFd) == 0;
+    } while (false);
+
+    munmap(p, size);
+    return ok;
+}
+
+// indice nuevo en .tmp + fsync + rename: al crearlo, al agrandar la tabla o despues de un corte
+bool Leaderboard::commitRewrite(int logFd, const std::vector<ScoreRecord>& recs, uint32_t journalGen) {
+    std::unique_ptr<IndexImage> next(new IndexImage);
+    std::string tmp = base + ".idx.tmp";
+
+    // partir del indice en disco, no del mapeado (otro proceso pudo haber escrito)
+    bool valid = false;
+    int fd = ::open((base + ".idx").c_str(), O_RDONLY);
+    if (fd >= 0) {
+        valid = readIndex(*next, fd);
+        ::close(fd);
+    }
+    struct stat st;
+    if (fstat(logFd, &st) != 0) return false;
+    off_t expected = (off_t)(next->head.h.recordCount * sizeof(ScoreRecord));
+    if (!valid) {
+        // commit en el lugar cortado: la cabecera dice hasta donde llegaba el indice publicado;
+        // lo del log que pasa de ahi sigue en el journal
+        const IndexHeader &h = next->head.h;
+        bool torn = h.magic == IDX_MAGIC && h.version == IDX_VERSION && (h.seq & 1) != 0;
+        uint32_t gen = torn ? h.journalGen : 0;
+        if (torn && st.st_size > expected && ftruncate(logFd, expected) != 0) return false;
+        next->head.h.journalGen = gen;
+        if (!rebuildFromLog(*next, logFd)) return false;
+    } else if (st.st_size > expected) {
+        if (ftruncate(logFd, expected) != 0) return false;
+    } else if (st.st_size < expected) {
+        if (!rebuildFromLog(*next, logFd)) return false;
+    }
+    expected = (off_t)(next->head.h.recordCount * sizeof(ScoreRecord));
+
+    if (!recs.empty()) {
+        if (!writeAll(logFd, recs.data(), recs.size() * sizeof(ScoreRecord), expected)) return false;
+        if (fdatasync(logFd) != 0) return false;
+        for (const ScoreRecord& r : recs) applyRecord(*next, r);
+    }
+    if (journalGen > next->head.h.journalGen) next->head.h.journalGen = journalGen;
+
+    int tfd = ::open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (tfd < 0) return false;
+    bool written = writeAll(tfd, &next->head, sizeof(IndexFile), 0)
+                && writeAll(tfd, next->players.data(), next->players.size() * sizeof(PlayerSlot), sizeof(IndexFile))
+                && fsync(tfd) == 0;
+    ::close(tfd);
+    if (!written || rename(tmp.c_str(), (base + ".idx").c_str()) != 0) return false;
+
+    // que el rename tambien sobreviva a un corte de luz
+    size_t slash = base.find_last_of('/');
+    std::string dir = (slash == std::string::npos) ? "." : base.substr(0, slash + 1);
+    int dfd = ::open(dir.c_str(), O_RDONLY | O_DIRECTORY);
+    if (dfd >= 0) { fsync(dfd); ::close(dfd); }
+    return true;
+}
+
+// el indice mapeado puede estar cambiando en el lugar (commit de este u otro proceso):
+// se copia y se repite si la secuencia era impar o cambio en el medio
+template <typename F> void Leaderboard::readConsistent(F fn) const {
+    for (int tries = 0; ; ++tries) {
+        uint32_t s0 = __atomic_load_n(&idx->h.seq, __ATOMIC_ACQUIRE);
+        fn();
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        uint32_t s1 = __atomic_load_n(&idx->h.seq, __ATOMIC_RELAXED);
+        // un commit cortado deja la secuencia impar hasta que alguien lo repare: no esperar para siempre
+        if ((s0 == s1 && (s0 & 1) == 0) || tries >= READ_TRIES) return;
+        sched_yield();
+    }
+}
+
+uint32_t Leaderboard::journalGen() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return idx ? idx->h.journalGen : 0;
+}
+
+ScoreRecord Leaderboard::makeRecord(const std::string& name, int score, int mode) {
+    ScoreRecord r;
+    memset(&r, 0, sizeof(r));
+    strncpy(r.name, name.c_str(), sizeof(r.name) - 1);
+    r.score = score;
+    r.mode = (uint8_t)mode;
+    r.timestamp = (int64_t)time(nullptr);
+    return r;
+}
+
+std::vector<ScoreRecord> Leaderboard::top(int mode, int n) const {
+    std::lock_guard<std::mutex> lock(mtx);
+    std::vector<ScoreRecord> out;
+    if (!idx || mode < 1 || mode > MODES) return out;
+    readConsistent([&] {
+        int count = std::min((int)idx->h.topCount[mode-1], n);
+        count = std::max(0, std::min(count, TOP_K));
+        out.assign(idx->top[mode-1], idx->top[mode-1] + count);
+    });
+    return out;
+}
+
+bool Leaderboard::playerBest(const std::string& name, int mode, int& best) const {
+    std::lock_guard<std::mutex> lock(mtx);
+    if (!idx || mode < 1 || mode > MODES) return false;
+    char key[24] = {0};
+    strncpy(key, name.c_str(), sizeof(key) - 1);
+    // busqueda de solo lectura sobre el mapeo (la tabla no cambia de largo en el lugar)
+    int found = -1;
+    readConsistent([&] {
+        found = -1;
+        int at = findPlayer(idxPlayers, idx->h.playerSlots, key, nameHash(key));
+        if (at >= 0 && idxPlayers[at].hash != 0) found = idxPlayers[at].best[mode-1];
+    });
+    if (found < 0) return false;
+    best = found;
+    return true;
+}
+
+uint64_t Leaderboard::totalGames() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return idx ? idx->h.recordCount : 0;
+}
@@ -0,0 +1,107 @@
+#ifndef LEADERBOARD_H
+#define LEADERBOARD_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <sys/types.h>
+
+// registro de una partida tal como queda en el log (tamaño fijo, binario)
+struct ScoreRecord {
+    char name[24];
+    int32_t score;
+    uint8_t mode;      // 1,2,3
+    uint8_t pad[3];
+    int64_t timestamp; // segundos desde epoch
+};
+
+// mejor puntaje de un jugador por modo (tabla hash dentro del indice)
+struct PlayerSlot {
+    char name[24];
+    int32_t best[3];   // -1 = sin partidas en ese modo
+    uint32_t hash;     // 0 = slot libre
+};
+
+// almacen de puntajes: log append-only (scores.log) + indice mapeado en memoria (scores.idx)
+// el indice guarda el top-K ordenado de cada modo y el mejor puntaje por jugador,
+// asi mostrar el top o buscar a un jugador no depende de cuantas partidas haya en el log.
+// la tabla de jugadores va al final del archivo y se duplica al llegar al 75%: no hay
+// limite de jugadores distintos (solo el tamaño del indice, ~36 bytes por slot).
+// commit() cambia el indice en el lugar (solo la cabecera, el top y los slots tocados, con
+// una secuencia impar mientras escribe); el archivo entero solo se reescribe (.tmp + rename)
+// al agrandar la tabla o al reconstruirlo desde el log despues de un corte a mitad de commit
+class Leaderboard {
+public:
+    static constexpr int TOP_K = 64;
+    static constexpr int MODES = 3;
+    static constexpr uint32_t MIN_PLAYER_SLOTS = 8192; // potencia de 2; crece duplicandose
+
+    Leaderboard();
+    ~Leaderboard();
+
+    bool open(const std::string& basePath); // crea/abre basePath.idx y basePath.log
+    void close();
+    bool isOpen() const;
+    bool refresh(); // vuelve a mapear si se publico un indice nuevo
+
+    // agrega registros: log + fsync, despues el indice (bloqueo entre procesos)
+    // journalGen = generacion del journal que queda aplicada con estos registros
+    bool commit(const std::vector<ScoreRecord>& recs, uint32_t journalGen);
+    uint32_t journalGen() const;
+
+    static ScoreRecord makeRecord(const std::string& name, int score, int mode);
+
+    // top-N del modo (1..3), ya ordenado de mayor a menor
+    std::vector<ScoreRecord> top(int mode, int n) const;
+    // mejor puntaje de un jugador en un modo; false si no tiene partidas
+    bool playerBest(const std::string& name, int mode, int& best) const;
+    uint64_t totalGames() const;
+
+private:
+    struct IndexHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t recordCount; // registros del log ya indexados
+        uint32_t playerCount;
+        uint32_t topCount[MODES];
+        uint32_t journalGen;
+        uint32_t playerSlots; // largo de la tabla que sigue a IndexFile en el archivo
+        uint32_t seq;         // impar: commit en curso (o cortado: hay que reconstruir)
+        uint32_t pad;
+    };
+    // prefijo de tamaño fijo del archivo; despues vienen playerSlots PlayerSlot
+    struct IndexFile {
+        IndexHeader h;
+        ScoreRecord top[MODES][TOP_K];
+    };
+    // indice en construccion (commit): el prefijo y la tabla, que puede crecer
+    struct IndexImage {
+        IndexFile head;
+        std::vector<PlayerSlot> players;
+    };
+
+    mutable std::mutex mtx; // el worker de ScoreWriter remapea mientras el menu lee
+    std::string base;
+    const IndexFile* idx;
+    const PlayerSlot* idxPlayers;
+    size_t idxSize;
+    ino_t idxIno;
+
+    bool mapIndex();
+    void unmapIndex();
+
+    static size_t fileSize(uint32_t slots) { return sizeof(IndexFile) + (size_t)slots * sizeof(PlayerSlot); }
+    static void initIndex(IndexImage& f);
+    static bool readIndex(IndexImage& f, int fd);
+    static bool rebuildFromLog(IndexImage& f, int logFd);
+    static void applyRecord(IndexImage& f, const ScoreRecord& r);
+    static void applyRecord(IndexFile& f, PlayerSlot* players, const ScoreRecord& r); // con lugar en la tabla
+    bool commitInPlace(int idxFd, int logFd, const std::vector<ScoreRecord>& recs, uint32_t journalGen, bool& done);
+    bool commitRewrite(int logFd, const std::vector<ScoreRecord>& recs, uint32_t journalGen);
+    template <typename F> void readConsistent(F fn) const;
+    static void growPlayers(IndexImage& f);
+    static int findPlayer(const PlayerSlot* slots, uint32_t n, const char* name, uint32_t h); // slot o libre; -1 si llena
+};
+
+#endif
@@ -0,0 +1,169 @@
+#include "Lockstep.h"
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <poll.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+
+static const uint32_t HELLO_MAGIC = 0x4c545341; // "ASTL"
+static const uint32_t HELLO_VERSION = 1;
+
+struct NetHello {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t seed;
+    int32_t worldW;
+    int32_t worldH;
+};
+
+static bool makeAddr(const std::string& path, sockaddr_un& addr) {
+    if (path.empty() || path.size() >= sizeof(addr.sun_path)) return false;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    memcpy(addr.sun_path, path.c_str(), path.size());
+    return true;
+}
+
+Lockstep::Lockstep()
+: role(NET_NONE), seed(0), worldW(0), worldH(0), fd(-1), listenFd(-1) {
+    for (int i = 0; i < HISTORY; ++i) {
+        histTick[i] = NO_CHECKSUM;
+        histSum[i] = 0;
+    }
+}
+
+Lockstep::~Lockstep() {
+    close();
+}
+
+bool Lockstep::listenOn(const std::string& path_) {
+    sockaddr_un addr;
+    if (!makeAddr(path_, addr)) return false;
+
+    listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listenFd < 0) return false;
+    unlink(path_.c_str()); // socket viejo de una partida que no cerro bien
+    if (bind(listenFd, (sockaddr*)&addr, sizeof(addr)) != 0 || listen(listenFd, 1) != 0) {
+        ::close(listenFd);
+        listenFd = -1;
+        return false;
+    }
+    path = path_;
+    return true;
+}
+
+bool Lockstep::acceptPeer(int timeoutMs) {
+    if (listenFd < 0) return false;
+    pollfd p = { listenFd, POLLIN, 0 };
+    if (poll(&p, 1, timeoutMs) <= 0) return false;
+    fd = accept(listenFd, NULL, NULL);
+    if (fd < 0) return false;
+    // un solo rival: no hace falta seguir escuchando
+    ::close(listenFd);
+    listenFd = -1;
+    unlink(path.c_str());
+    path.clear();
+    return true;
+}
+
+bool Lockstep::tryConnect(const std::string& path_) {
+    sockaddr_un addr;
+    if (!makeAddr(path_, addr)) return false;
+
+    fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return false;
+    if (connect(fd, (sockaddr*)&addr, sizeof(addr)) != 0) {
+        ::close(fd);
+        fd = -1;
+        return false;
+    }
+    return true;
+}
+
+void Lockstep::close() {
+    if (fd >= 0) ::close(fd);
+    if (listenFd >= 0) ::close(listenFd);
+    if (!path.empty()) unlink(path.c_str());
+    fd = listenFd = -1;
+    path.clear();
+}
+
+bool Lockstep::sendHello(uint64_t seed_, int worldW_, int worldH_) {
+    NetHello h;
+    memset(&h, 0, sizeof(h));
+    h.magic = HELLO_MAGIC;
+    h.version = HELLO_VERSION;
+    h.seed = seed_;
+    h.worldW = worldW_;
+    h.worldH = worldH_;
+    if (!writeExact(&h, sizeof(h))) return false;
+    seed = seed_;
+    worldW = worldW_;
+    worldH = worldH_;
+    return true;
+}
+
+bool Lockstep::recvHello(int timeoutMs) {
+    NetHello h;
+    if (!readExact(&h, sizeof(h), timeoutMs)) return false;
+    if (h.magic != HELLO_MAGIC || h.version != HELLO_VERSION) return false;
+    if (h.worldW <= 8 || h.worldH <= 4) return false;
+    seed = h.seed;
+    worldW = h.worldW;
+    worldH = h.worldH;
+    return true;
+}
+
+bool Lockstep::send(const InputFrame& f) {
+    return writeExact(&f, sizeof(f));
+}
+
+bool Lockstep::recv(InputFrame& f, int timeoutMs) {
+    return readExact(&f, sizeof(f), timeoutMs);
+}
+
+void Lockstep::recordChecksum(uint32_t tick, uint32_t cs) {
+    histTick[tick % HISTORY] = tick;
+    histSum[tick % HISTORY] = cs;
+}
+
+bool Lockstep::checkRemote(const InputFrame& f) const {
+    if (f.csTick == NO_CHECKSUM) return true;
+    int slot = f.csTick % HISTORY;
+    // demasiado viejo para comparar (no deberia pasar con INPUT_DELAY chico)
+    if (histTick[slot] != f.csTick) return true;
+    return histSum[slot] == f.checksum;
+}
+
+// lee exactamente len bytes; false si se corta la conexion o pasa el timeout
+bool Lockstep::readExact(void* buf, size_t len, int timeoutMs) {
+    if (fd < 0) return false;
+    char* p = (char*)buf;
+    while (len > 0) {
+        pollfd pf = { fd, POLLIN, 0 };
+        int r = poll(&pf, 1, timeoutMs);
+        if (r < 0 && errno == EINTR) continue;
+        if (r <= 0) return false;
+        ssize_t n = ::recv(fd, p, len, 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        p += n;
+        len -= n;
+    }
+    return true;
+}
+
+bool Lockstep::writeExact(const void* buf, size_t len) {
+    if (fd < 0) return false;
+    const char* p = (const char*)buf;
+    while (len > 0) {
+        // MSG_NOSIGNAL: si el otro proceso murio, error en vez de SIGPIPE
+        ssize_t n = ::send(fd, p, len, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        p += n;
+        len -= n;
+    }
+    return true;
+}
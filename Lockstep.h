@@ -0,0 +1,79 @@
+#ifndef LOCKSTEP_H
+#define LOCKSTEP_H
+
+#include <cstdint>
+#include <string>
+
+// multijugador local entre dos procesos por un socket Unix.
+// solo viajan las teclas de cada tick (16 bytes): ambos procesos simulan lo mismo a partir de
+// la misma semilla y las mismas entradas, y cada tanto comparan un checksum del estado
+
+enum NetRole {
+    NET_NONE = 0,
+    NET_HOST = 1, // jugador 1, crea el socket y elige semilla y tamaño del mundo
+    NET_JOIN = 2  // jugador 2
+};
+
+enum InputBits : uint8_t {
+    IN_LEFT   = 1,
+    IN_RIGHT  = 2,
+    IN_THRUST = 4,
+    IN_FIRE   = 8,
+    IN_PAUSE  = 16,
+    IN_QUIT   = 32
+};
+
+struct InputFrame {
+    uint32_t tick;     // tick en el que se aplican estas teclas
+    uint32_t csTick;   // tick del checksum que se adjunta (NO_CHECKSUM si no hay)
+    uint32_t checksum;
+    uint8_t keys;      // InputBits
+    uint8_t pad[3];
+};
+
+static const uint32_t NO_CHECKSUM = 0xffffffffu;
+
+class Lockstep {
+public:
+    static const int INPUT_DELAY = 2;     // ticks de margen para que la entrada remota ya este
+    static const int CHECKSUM_EVERY = 30; // ticks entre checksums
+    static const int RECV_TIMEOUT_MS = 5000;
+
+    Lockstep();
+    ~Lockstep();
+
+    bool listenOn(const std::string& path);
+    bool acceptPeer(int timeoutMs);        // true cuando se conecto el jugador 2
+    bool tryConnect(const std::string& path);
+    void close();
+    bool connected() const { return fd >= 0; }
+
+    // saludo inicial: el host manda semilla y mundo, el cliente los adopta
+    bool sendHello(uint64_t seed, int worldW, int worldH);
+    bool recvHello(int timeoutMs);
+
+    bool send(const InputFrame& f);
+    bool recv(InputFrame& f, int timeoutMs);
+
+    // guarda el checksum local de un tick y compara con el que manda el otro
+    void recordChecksum(uint32_t tick, uint32_t cs);
+    bool checkRemote(const InputFrame& f) const; // false = desincronizados
+
+    NetRole role;
+    uint64_t seed;
+    int worldW, worldH;
+
+private:
+    bool readExact(void* buf, size_t len, int timeoutMs);
+    bool writeExact(const void* buf, size_t len);
+
+    int fd;
+    int listenFd;
+    std::string path;
+
+    static const int HISTORY = 64;
+    uint32_t histTick[HISTORY];
+    uint32_t histSum[HISTORY];
+};
+
+#endif
@@ -0,0 +1,124 @@
+#include "Particles.h"
+#include "Trig.h"
+#include <algorithm>
+#include <cstring>
+#include <ctime>
+
+static const size_t MAX_PENDING = 256; // pedidos por cuadro; si drawThread se atrasa se descartan
+static const float DEBRIS_SPEED = 12.0f; // celdas por segundo
+static const float DEBRIS_TTL = 0.6f;
+static const float TRAIL_TTL = 0.25f;
+static const int LANES = 4; // la capacidad se redondea a multiplo de esto
+
+typedef float F4 __attribute__((vector_size(16)));
+
+// p += v * dt para 4 particulas (memcpy: los vector<float> no garantizan alineacion a 16)
+static inline void step(float* p, const float* v, float dt) {
+    F4 a, b;
+    memcpy(&a, p, sizeof(a));
+    memcpy(&b, v, sizeof(b));
+    a += b * dt;
+    memcpy(p, &a, sizeof(a));
+}
+
+ParticlePool::ParticlePool() : cap(0), perFrame(0), head(0), rng((uint64_t)time(NULL)), overwritten(0), capped(0) {}
+
+void ParticlePool::setCapacity(int n) {
+    cap = n > 0 ? (n + LANES - 1) / LANES * LANES : 0;
+    perFrame = cap > 0 ? std::max(cap / 4, LANES) : 0;
+    px.assign(cap, 0.0f);
+    py.assign(cap, 0.0f);
+    vx.assign(cap, 0.0f);
+    vy.assign(cap, 0.0f);
+    life.assign(cap, 0.0f);
+    maxLife.assign(cap, 1.0f);
+    kind.assign(cap, 0);
+    head = 0;
+    pending.reserve(MAX_PENDING);
+    draining.reserve(MAX_PENDING);
+}
+
+void ParticlePool::clear() {
+    std::lock_guard<std::mutex> lock(mtx);
+    pending.clear();
+    for (int i = 0; i < cap; ++i) life[i] = 0.0f;
+    head = 0;
+    overwritten = 0;
+    capped = 0;
+}
+
+void ParticlePool::explode(double x, double y, int count, ParticleKind k) {
+    if (cap == 0 || count <= 0) return;
+    std::lock_guard<std::mutex> lock(mtx);
+    if (pending.size() >= MAX_PENDING) return;
+    pending.push_back(Burst{ (float)x, (float)y, 0.0f, 0.0f, (uint16_t)count, (uint8_t)k });
+}
+
+void ParticlePool::trail(double x, double y, double dx, double dy, ParticleKind k) {
+    if (cap == 0) return;
+    std::lock_guard<std::mutex> lock(mtx);
+    if (pending.size() >= MAX_PENDING) return;
+    pending.push_back(Burst{ (float)x, (float)y, (float)dx, (float)dy, 0, (uint8_t)k });
+}
+
+void ParticlePool::spawn(float x, float y, float dx, float dy, float ttl, uint8_t k) {
+    int i = head;
+    head = (head + 1 == cap) ? 0 : head + 1;
+    if (life[i] > 0.0f) overwritten++;
+    px[i] = x;
+    py[i] = y;
+    vx[i] = dx;
+    vy[i] = dy;
+    life[i] = maxLife[i] = ttl;
+    kind[i] = k;
+}
+
+void ParticlePool::update(float dt) {
+    if (cap == 0) return;
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        draining.swap(pending);
+    }
+    // tope por cuadro: lo que no entra se descarta (no se arrastra: seria un efecto atrasado)
+    int left = perFrame;
+    for (auto &b : draining) {
+        int n = b.count == 0 ? 1 : b.count;
+        if (n > left) {
+            capped += n - left;
+            n = left;
+        }
+        left -= n;
+        if (n == 0) continue;
+        if (b.count == 0) {
+            spawn(b.x, b.y, b.vx, b.vy, TRAIL_TTL, b.kind);
+            continue;
+        }
+        for (int j = 0; j < n; ++j) {
+            int d = rng.range(SHIP_DIRS);
+            float speed = DEBRIS_SPEED * (0.3f + 0.7f * (float)rng.range(1000) / 1000.0f);
+            float ttl = DEBRIS_TTL * (0.5f + 0.5f * (float)rng.range(1000) / 1000.0f);
+            spawn(b.x, b.y, (float)DIR_TABLES.cos[d] * speed, (float)DIR_TABLES.sin[d] * speed, ttl, b.kind);
+        }
+    }
+    draining.clear();
+
+    // sin ramas sobre arreglos contiguos, de a 4 floats por instruccion (extension de
+    // vectores de gcc/clang: no depende de que el optimizador decida vectorizar).
+    // las muertas tambien se mueven, da igual. no se envuelve al mundo: una particula no vive
+    // lo suficiente para alejarse mas de unas celdas, y worldToScreen ya toma la diferencia envuelta
+    for (int i = 0; i < cap; i += LANES) {
+        step(&px[i], &vx[i], dt);
+        step(&py[i], &vy[i], dt);
+        F4 l;
+        memcpy(&l, &life[i], sizeof(l));
+        l -= dt;
+        memcpy(&life[i], &l, sizeof(l));
+    }
+}
+
+char ParticlePool::glyphFor(float frac) {
+    if (frac > 0.75f) return '#';
+    if (frac > 0.5f) return '*';
+    if (frac > 0.25f) return '+';
+    return '.';
+}
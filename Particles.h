@@ -0,0 +1,76 @@
+#ifndef PARTICLES_H
+#define PARTICLES_H
+
+#include <cstdint>
+#include <mutex>
+#include <vector>
+#include "Rng.h"
+
+// efectos de particulas (explosiones, estela del impulso). son solo visuales: no tocan el
+// estado del juego ni su Rng, asi que no afectan lockstep ni snapshots.
+//
+// los datos van en arreglos separados (SoA) reservados una vez: el paso de actualizacion
+// recorre floats contiguos sin ramas, de a 4 con las extensiones de vectores de gcc/clang.
+// el pool es un anillo de capacidad fija: una particula nueva pisa a la mas vieja, asi que
+// update y dibujo nunca recorren mas de capacity() particulas. ademas en cada cuadro se crean
+// a lo sumo capacity()/4: una lluvia de explosiones no se come el cuadro ni vacia el anillo
+
+enum ParticleKind : uint8_t {
+    PK_DEBRIS = 0, // restos de asteroide
+    PK_SHIP1 = 1,  // explosion / estela de la nave 1 (color del jugador)
+    PK_SHIP2 = 2
+};
+
+class ParticlePool {
+public:
+    ParticlePool();
+
+    // particulas vivas como maximo (0 desactiva los efectos). no es thread-safe:
+    // llamar con drawThread detenido
+    void setCapacity(int n);
+    int capacity() const { return cap; }
+
+    // cualquier hilo: se encolan y las crea drawThread en el proximo cuadro
+    void explode(double x, double y, int count, ParticleKind kind);
+    void trail(double x, double y, double vx, double vy, ParticleKind kind);
+
+    // drawThread: crea las pendientes (hasta el tope por cuadro) y avanza dt segundos
+    void update(float dt);
+
+    // drawThread: fn(x, y, glyph, kind) por cada particula viva
+    template <typename F> void forEach(F fn) const {
+        for (int i = 0; i < cap; ++i) {
+            if (life[i] <= 0.0f) continue;
+            fn(px[i], py[i], glyphFor(life[i] / maxLife[i]), (ParticleKind)kind[i]);
+        }
+    }
+
+    void clear(); // drawThread detenido
+    uint64_t dropped() const { return overwritten; } // vivas pisadas por falta de lugar
+    uint64_t skipped() const { return capped; }      // no creadas por el tope por cuadro
+
+private:
+    struct Burst {
+        float x, y, vx, vy;
+        uint16_t count; // 0 = estela (una particula con vx, vy)
+        uint8_t kind;
+    };
+
+    static char glyphFor(float frac);
+    void spawn(float x, float y, float vx, float vy, float ttl, uint8_t k);
+
+    std::mutex mtx;
+    std::vector<Burst> pending, draining; // pending protegido por mtx
+
+    // solo drawThread
+    int cap;
+    int perFrame; // particulas nuevas por cuadro como maximo
+    int head; // proxima posicion a escribir (la mas vieja)
+    std::vector<float> px, py, vx, vy, life, maxLife;
+    std::vector<uint8_t> kind;
+    Rng rng;
+    uint64_t overwritten;
+    uint64_t capped;
+};
+
+#endif
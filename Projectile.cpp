@@ -1,30 +1,39 @@
 #include "Projectile.h"
 #include <cmath>
+#include "Fixed.h"
 
 Projectile::Projectile(double x, double y, double vx, double vy, int lifeTicks, int owner_) {
     pos.x = x; 
     pos.y = y;
+    prev = pos;
     vel.x = vx; 
     vel.y = vy;
     life = lifeTicks;
     owner = owner_;
 }
 
-void Projectile::update(double dt, int maxx, int maxy) {
+void Projectile::update(double dt, int worldW, int worldH) {
+    prev = pos;
+#ifdef FIXED_POINT_PHYSICS
+    Vec2 step = fixedStep(pos, vel, dt, worldW, worldH);
+    sweep.x += step.x;
+    sweep.y += step.y;
+#else
     pos.x += vel.x * dt;
     pos.y += vel.y * dt;
+    sweep.x += vel.x * dt;
+    sweep.y += vel.y * dt;
     
-    pos.x = fmod(pos.x, (double)maxx);
-    if (pos.x < 0) pos.x += (double)maxx;
-    
-    double y_min = 1.0;
-    double y_range = (double)(maxy - 1);
-    pos.y = y_min + fmod(pos.y - y_min, y_range);
-    if (pos.y < y_min) pos.y += y_range;
+    wrapPosition(pos, worldW, worldH);
+#endif
     
     life--;
 }
 
 bool Projectile::alive() const { 
     return life > 0; 
+}
+
+PackedBody Projectile::pack() const {
+    return packBody(pos, vel, BODY_BULLET, owner, life);
 }
\ No newline at end of file
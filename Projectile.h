@@ -2,16 +2,20 @@
 #define PROJECTILE_H
 
 #include "Ship.h"
+#include "Fixed.h"
 
 struct Projectile {
     Vec2 pos;
+    Vec2 prev; // posicion del tick anterior (para interpolar al dibujar)
     Vec2 vel;
+    Vec2 sweep; // desplazamiento desde la ultima revision de colisiones (sin envolver)
     int life; 
     int owner; // 1 = player1, 2 = player2
 
     Projectile(double x, double y, double vx, double vy, int lifeTicks=60, int owner_ = 1);
-    void update(double dt, int maxx, int maxy);
+    void update(double dt, int worldW, int worldH);
     bool alive() const;
+    PackedBody pack() const; // registro compacto de 16 bytes
 };
 
 #endif
\ No newline at end of file
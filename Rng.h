@@ -0,0 +1,30 @@
+#ifndef RNG_H
+#define RNG_H
+
+#include <cstdint>
+
+// generador pseudoaleatorio del juego (splitmix64).
+// a diferencia de rand() o de las distribuciones de <random>, da la misma secuencia en
+// cualquier compilador y libc, y todo su estado es un entero: se puede sincronizar entre
+// dos procesos (lockstep) y guardar en un snapshot
+struct Rng {
+    uint64_t state;
+
+    explicit Rng(uint64_t seed = 1) : state(seed) {}
+
+    void seed(uint64_t s) { state = s; }
+
+    uint64_t next() {
+        uint64_t z = (state += 0x9e3779b97f4a7c15ull);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        return z ^ (z >> 31);
+    }
+
+    // entero en [0, n)
+    int range(int n) {
+        return (int)(next() % (uint64_t)n);
+    }
+};
+
+#endif
@@ -0,0 +1,213 @@
+#include "ScoreWriter.h"
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static const uint32_t JOURNAL_MAGIC = 0x41534a4e; // "ASJN"
+static const uint32_t JOURNAL_VERSION = 1;
+
+// politica del worker
+static const int BATCH_WAIT_MS = 200;   // espera para juntar varios puntajes en un lote
+static const int SYNC_EVERY_MS = 500;   // fsync periodico del journal
+static const int COMPACT_IDLE_MS = 1000; // compactar tras este tiempo sin puntajes nuevos
+static const size_t COMPACT_EVERY = 64;  // o al llegar a esta cantidad de entradas
+
+static uint32_t recordSum(const ScoreRecord& r, uint32_t gen) {
+    const uint8_t* p = (const uint8_t*)&r;
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < sizeof(r); ++i) {
+        h ^= p[i];
+        h *= 16777619u;
+    }
+    return h ^ (gen * 0x9e3779b9u);
+}
+
+ScoreWriter::ScoreWriter(Leaderboard& lb_)
+: lb(lb_), journalFd(-1), journalCount(0), running(false), stopping(false) {}
+
+ScoreWriter::~ScoreWriter() {
+    stop();
+}
+
+bool ScoreWriter::start(const std::string& basePath) {
+    if (running) return true;
+    if (!lb.open(basePath)) return false;
+
+    journalPath = basePath + ".journal";
+    journalFd = ::open(journalPath.c_str(), O_RDWR | O_CREAT | O_APPEND, 0644);
+    if (journalFd < 0) return false;
+
+    // journal nuevo: escribir la cabecera con la generacion actual del indice
+    flock(journalFd, LOCK_EX);
+    struct stat st;
+    if (fstat(journalFd, &st) == 0 && st.st_size < (off_t)sizeof(JournalHeader)) {
+        JournalHeader hdr = { JOURNAL_MAGIC, JOURNAL_VERSION, lb.journalGen(), 0 };
+        if (ftruncate(journalFd, 0) != 0 || write(journalFd, &hdr, sizeof(hdr)) != (ssize_t)sizeof(hdr)) {
+            flock(journalFd, LOCK_UN);
+            ::close(journalFd);
+            journalFd = -1;
+            return false;
+        }
+        fdatasync(journalFd);
+    }
+    flock(journalFd, LOCK_UN);
+
+    // recuperacion: lo que haya quedado en el journal (crash, corte) se aplica ahora
+    compact();
+
+    stopping = false;
+    running = true;
+    pthread_create(&worker, NULL, workerThread, this);
+    return true;
+}
+
+void ScoreWriter::stop() {
+    if (!running) return;
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        stopping = true;
+    }
+    cv.notify_all();
+    pthread_join(worker, NULL);
+    running = false;
+
+    if (journalFd >= 0) {
+        ::close(journalFd);
+        journalFd = -1;
+    }
+}
+
+void ScoreWriter::submit(const std::string& name, int score, int mode) {
+    if (!running) return; // sin journal no hay quien lo guarde (isRunning() para avisar)
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        queue.push_back(Leaderboard::makeRecord(name, score, mode));
+    }
+    cv.notify_one();
+}
+
+bool ScoreWriter::appendBatch(const std::vector<ScoreRecord>& batch, bool sync) {
+    std::vector<JournalEntry> entries(batch.size());
+
+    // un solo write por lote (O_APPEND), con el lock para no mezclarse con la compactacion de otro kiosco.
+    // la generacion se lee del indice publicado bajo el mismo lock: si una compactacion se corto
+    // despues de publicar el indice, estas entradas quedan marcadas como nuevas y no se descartan con las viejas
+    size_t len = entries.size() * sizeof(JournalEntry);
+    flock(journalFd, LOCK_EX);
+    lb.refresh();
+    uint32_t gen = lb.journalGen();
+    for (size_t i = 0; i < batch.size(); ++i) {
+        memset(&entries[i], 0, sizeof(JournalEntry));
+        entries[i].rec = batch[i];
+        entries[i].gen = gen;
+        entries[i].sum = recordSum(batch[i], gen);
+    }
+    bool ok = write(journalFd, entries.data(), len) == (ssize_t)len;
+    if (ok && sync) fdatasync(journalFd);
+    flock(journalFd, LOCK_UN);
+
+    if (ok) journalCount += entries.size();
+    return ok;
+}
+
+bool ScoreWriter::compact() {
+    flock(journalFd, LOCK_EX);
+
+    JournalHeader hdr;
+    bool valid = pread(journalFd, &hdr, sizeof(hdr), 0) == (ssize_t)sizeof(hdr)
+              && hdr.magic == JOURNAL_MAGIC && hdr.version == JOURNAL_VERSION;
+
+    lb.refresh();
+    uint32_t idxGen = lb.journalGen();
+
+    // el journal entero (se compacta seguido, es chico). una entrada cortada (kiosco que murio
+    // a mitad de un write) no corta la lectura: las que otros agregaron despues siguen ahi,
+    // corridas de alineacion, asi que se busca la proxima con checksum valido byte a byte
+    std::vector<ScoreRecord> recs;
+    struct stat st;
+    if (valid && fstat(journalFd, &st) == 0 && st.st_size > (off_t)sizeof(JournalHeader)) {
+        std::vector<char> data((size_t)st.st_size - sizeof(JournalHeader));
+        ssize_t n = pread(journalFd, data.data(), data.size(), sizeof(JournalHeader));
+        size_t len = n > 0 ? (size_t)n : 0;
+        size_t off = 0;
+        while (off + sizeof(JournalEntry) <= len) {
+            JournalEntry e;
+            memcpy(&e, data.data() + off, sizeof(e));
+            if (e.sum != recordSum(e.rec, e.gen)) {
+                off++;
+                continue;
+            }
+            off += sizeof(JournalEntry);
+            // escrita antes de que el indice pasara a idxGen: la compactacion que lo
+            // publico ya la aplico (se corto antes de vaciar el journal)
+            if (e.gen < idxGen) continue;
+            recs.push_back(e.rec);
+        }
+    }
+    // solo las entradas de la generacion actual: las viejas ya estan en el indice
+    uint32_t newGen = idxGen;
+    if (!recs.empty()) {
+        if (!lb.commit(recs, idxGen + 1)) {
+            flock(journalFd, LOCK_UN);
+            return false;
+        }
+        newGen = idxGen + 1;
+    }
+
+    JournalHeader fresh = { JOURNAL_MAGIC, JOURNAL_VERSION, newGen, 0 };
+    bool ok = ftruncate(journalFd, 0) == 0
+           && write(journalFd, &fresh, sizeof(fresh)) == (ssize_t)sizeof(fresh);
+    if (ok) fdatasync(journalFd);
+    journalCount = 0;
+
+    flock(journalFd, LOCK_UN);
+    return ok;
+}
+
+void* ScoreWriter::workerThread(void* arg) {
+    ScoreWriter* w = (ScoreWriter*)arg;
+    pthread_setname_np(pthread_self(), "ast-scores");
+    using clock = std::chrono::steady_clock;
+    clock::time_point lastSync = clock::now();
+    clock::time_point lastWrite = clock::now();
+    bool dirty = false;
+    std::vector<ScoreRecord> batch;
+
+    while (true) {
+        bool stop;
+        {
+            std::unique_lock<std::mutex> lock(w->mtx);
+            w->cv.wait_for(lock, std::chrono::milliseconds(BATCH_WAIT_MS),
+                [w]{ return !w->queue.empty() || w->stopping; });
+            batch.swap(w->queue);
+            stop = w->stopping;
+        }
+
+        clock::time_point now = clock::now();
+        bool syncDue = stop || now - lastSync >= std::chrono::milliseconds(SYNC_EVERY_MS);
+
+        if (!batch.empty()) {
+            w->appendBatch(batch, syncDue);
+            batch.clear();
+            lastWrite = now;
+            dirty = !syncDue;
+            if (syncDue) lastSync = now;
+        } else if (dirty && syncDue) {
+            fdatasync(w->journalFd);
+            dirty = false;
+            lastSync = now;
+        }
+
+        bool idle = now - lastWrite >= std::chrono::milliseconds(COMPACT_IDLE_MS);
+        if (w->journalCount >= COMPACT_EVERY || (w->journalCount > 0 && idle) || stop) {
+            w->compact();
+        }
+
+        if (stop) break;
+    }
+
+    return NULL;
+}
@@ -0,0 +1,57 @@
+#ifndef SCOREWRITER_H
+#define SCOREWRITER_H
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <pthread.h>
+#include "Leaderboard.h"
+
+// guarda puntajes en segundo plano para no bloquear el menu.
+// cada lote se agrega a un journal (scores.journal) con fsync periodico, y cada cierto tiempo
+// se compacta: los registros pasan al Leaderboard (log + indice, ver Leaderboard::commit)
+// y el journal vuelve a quedar vacio. al iniciar se re-aplica lo que haya quedado en el journal
+class ScoreWriter {
+public:
+    explicit ScoreWriter(Leaderboard& lb);
+    ~ScoreWriter();
+
+    bool start(const std::string& basePath); // recupera el journal y lanza el hilo
+    bool isRunning() const { return running; } // false si start fallo: submit descarta
+    void stop();                             // vacia la cola, compacta y espera al hilo
+
+    // encola el puntaje; nunca hace IO en el hilo que llama
+    void submit(const std::string& name, int score, int mode);
+
+private:
+    struct JournalHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t gen; // generacion: sube cada vez que el journal se compacta
+        uint32_t pad;
+    };
+    struct JournalEntry {
+        ScoreRecord rec;
+        uint32_t sum; // detecta una entrada cortada al final del archivo
+        uint32_t gen; // generacion del indice al escribirla: si el indice ya es mayor, ya esta aplicada
+    };
+
+    static void* workerThread(void* arg);
+    bool appendBatch(const std::vector<ScoreRecord>& batch, bool sync);
+    bool compact();
+
+    Leaderboard& lb;
+    std::string journalPath;
+    int journalFd;
+    size_t journalCount; // entradas escritas desde la ultima compactacion
+
+    pthread_t worker;
+    bool running;
+    bool stopping;
+    std::mutex mtx;
+    std::condition_variable cv;
+    std::vector<ScoreRecord> queue;
+};
+
+#endif
@@ -0,0 +1,107 @@
+#include "Script.h"
+#include <cstdio>
+#include <ctime>
+#include <string>
+
+static const char* SCRIPT_LOG_PATH = "debug.log";
+
+Scheduler::Scheduler() : tickCount(0), seq(0), live(0) {}
+
+Scheduler::~Scheduler() {
+    clear();
+}
+
+void Scheduler::spawn(Script s) {
+    std::coroutine_handle<> h = s.release();
+    if (!h) return;
+    live++;
+    sleep(h, 1);
+}
+
+void Scheduler::sleep(std::coroutine_handle<> h, uint64_t n) {
+    sleepers.push(Sleeper{ tickCount + n, seq++, h });
+}
+
+void Scheduler::resume(std::coroutine_handle<> h) {
+    h.resume();
+    // termino el script (llego a final_suspend): liberar su frame.
+    // todos los handles que maneja el Scheduler son de Script (spawn y los awaiters)
+    if (h.done()) {
+        auto& p = std::coroutine_handle<Script::promise_type>::from_address(h.address()).promise();
+        if (p.error) logError(p.error);
+        h.destroy();
+        live--;
+    }
+}
+
+// una linea en debug.log por script que termino con una excepcion; los demas siguen
+void Scheduler::logError(std::exception_ptr e) {
+    const char* what = "excepcion desconocida";
+    std::string msg;
+    try {
+        std::rethrow_exception(e);
+    } catch (const std::exception& ex) {
+        msg = ex.what();
+        what = msg.c_str();
+    } catch (...) {
+    }
+    FILE* f = fopen(SCRIPT_LOG_PATH, "a");
+    if (!f) return;
+    time_t now = time(nullptr);
+    char when[32];
+    strftime(when, sizeof(when), "%Y-%m-%d %H:%M:%S", localtime(&now));
+    fprintf(f, "[%s] script abortado: %s\n", when, what);
+    fclose(f);
+}
+
+void Scheduler::emit(int event) {
+    std::lock_guard<std::mutex> lock(mtxEvents);
+    pendingEvents.push_back(event);
+}
+
+void Scheduler::tick() {
+    tickCount++;
+
+    // eventos emitidos desde otros hilos desde el tick anterior
+    std::vector<int> events;
+    {
+        std::lock_guard<std::mutex> lock(mtxEvents);
+        events.swap(pendingEvents);
+    }
+    due.clear();
+    for (int e : events) {
+        auto it = waiters.find(e);
+        if (it == waiters.end()) continue;
+        due.insert(due.end(), it->second.begin(), it->second.end());
+        it->second.clear();
+    }
+
+    // los que duermen hasta este tick (el heap los entrega en orden)
+    while (!sleepers.empty() && sleepers.top().wake <= tickCount) {
+        due.push_back(sleepers.top().h);
+        sleepers.pop();
+    }
+
+    // se copia: un script reanudado puede volver a dormir o esperar y tocar las colas
+    std::vector<std::coroutine_handle<>> run;
+    run.swap(due);
+    for (auto h : run) resume(h);
+    run.clear();
+    due.swap(run);
+}
+
+void Scheduler::clear() {
+    while (!sleepers.empty()) {
+        sleepers.top().h.destroy();
+        sleepers.pop();
+    }
+    for (auto &w : waiters) {
+        for (auto h : w.second) h.destroy();
+    }
+    waiters.clear();
+    {
+        std::lock_guard<std::mutex> lock(mtxEvents);
+        pendingEvents.clear();
+    }
+    live = 0;
+}
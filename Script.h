@@ -0,0 +1,118 @@
+#ifndef SCRIPT_H
+#define SCRIPT_H
+
+#include <coroutine>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <queue>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// comportamientos especiales (oleadas con tiempo, enemigos, power-ups) como corrutinas C++20.
+// cada script hace co_await de ticks o eventos y el Scheduler los reanuda dentro del tick
+// de simulacion: miles de scripts sin hilos propios ni cambios de contexto del sistema.
+// (requiere compilar con -std=c++20)
+
+class Scheduler;
+
+// tipo de retorno de un script: Script miScript() { ... co_await sched.ticks(30); ... }
+// es dueño del frame hasta que se lo pasa a Scheduler::spawn; si nunca llega, lo destruye
+struct Script {
+    struct promise_type {
+        Script get_return_object() {
+            return Script(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; } // arranca en el proximo tick
+        std::suspend_always final_suspend() noexcept { return {}; }   // el scheduler lo destruye
+        void return_void() {}
+        // no se deja escapar al hilo de simulacion: el script termina y el Scheduler lo anota
+        void unhandled_exception() { error = std::current_exception(); }
+
+        std::exception_ptr error;
+    };
+
+    explicit Script(std::coroutine_handle<promise_type> handle) : h(handle) {}
+    Script(Script&& o) noexcept : h(std::exchange(o.h, nullptr)) {}
+    Script& operator=(Script&& o) noexcept {
+        if (this != &o) {
+            if (h) h.destroy();
+            h = std::exchange(o.h, nullptr);
+        }
+        return *this;
+    }
+    Script(const Script&) = delete;
+    Script& operator=(const Script&) = delete;
+    ~Script() {
+        if (h) h.destroy();
+    }
+
+    // suelta el frame (spawn): desde aca lo destruye el Scheduler
+    std::coroutine_handle<promise_type> release() { return std::exchange(h, nullptr); }
+
+private:
+    std::coroutine_handle<promise_type> h;
+};
+
+class Scheduler {
+public:
+    Scheduler();
+    ~Scheduler();
+
+    // toma el script y lo ejecuta desde el siguiente tick
+    void spawn(Script s);
+    // avanza un tick: reanuda los scripts que despiertan ahora y los que esperaban eventos emitidos
+    void tick();
+    // se puede llamar desde cualquier hilo; los que esperan se reanudan en el proximo tick
+    void emit(int event);
+    // destruye todos los scripts pendientes (fin de partida)
+    void clear();
+
+    uint64_t now() const { return tickCount; }
+    size_t size() const { return live; }
+
+    struct TickAwaiter {
+        Scheduler& s;
+        uint64_t n;
+        bool await_ready() const noexcept { return n == 0; }
+        void await_suspend(std::coroutine_handle<> h) { s.sleep(h, n); }
+        void await_resume() const noexcept {}
+    };
+    struct EventAwaiter {
+        Scheduler& s;
+        int event;
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> h) { s.waiters[event].push_back(h); }
+        void await_resume() const noexcept {}
+    };
+
+    TickAwaiter ticks(uint64_t n) { return TickAwaiter{ *this, n }; }
+    EventAwaiter event(int e) { return EventAwaiter{ *this, e }; }
+
+private:
+    struct Sleeper {
+        uint64_t wake;
+        uint64_t seq; // desempate: mismo tick -> orden de llegada (determinista)
+        std::coroutine_handle<> h;
+        bool operator>(const Sleeper& o) const {
+            return wake != o.wake ? wake > o.wake : seq > o.seq;
+        }
+    };
+
+    void sleep(std::coroutine_handle<> h, uint64_t n);
+    void resume(std::coroutine_handle<> h);
+    static void logError(std::exception_ptr e);
+
+    uint64_t tickCount;
+    uint64_t seq;
+    size_t live;
+    std::priority_queue<Sleeper, std::vector<Sleeper>, std::greater<Sleeper>> sleepers;
+    std::unordered_map<int, std::vector<std::coroutine_handle<>>> waiters;
+    std::vector<std::coroutine_handle<>> due; // reutilizado entre ticks
+
+    std::mutex mtxEvents;
+    std::vector<int> pendingEvents;
+};
+
+#endif
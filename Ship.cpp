@@ -1,25 +1,36 @@
 #include "Ship.h"
+#include "Fixed.h"
+#include "Trig.h"
 
 Ship::Ship(double x, double y) {
     pos.x = x; 
     pos.y = y;
+    prev = pos;
     vel.x = vel.y = 0.0;
-    angle = -M_PI/2; // apunta arriba
+    dir = SHIP_START_DIR; // apunta arriba
     lives.store(3);  // Use store() para inicializar atomic 
     score.store(0);
 }
 
-void Ship::rotateLeft(double delta) { 
-    angle -= delta; 
+void Ship::rotateLeft() { 
+    dir = (dir + SHIP_DIRS - 1) % SHIP_DIRS; 
 }
 
-void Ship::rotateRight(double delta) { 
-    angle += delta; 
+void Ship::rotateRight() { 
+    dir = (dir + 1) % SHIP_DIRS; 
+}
+
+double Ship::dirX() const {
+    return DIR_TABLES.cos[dir];
+}
+
+double Ship::dirY() const {
+    return DIR_TABLES.sin[dir];
 }
 
 void Ship::thrust(double power) {
-    vel.x += cos(angle) * power;
-    vel.y += sin(angle) * power;
+    vel.x += DIR_TABLES.cos[dir] * power;
+    vel.y += DIR_TABLES.sin[dir] * power;
     
     // limitar velocidad maxima a 3.5 unidades para evitar que se salga de control 
     double speed = sqrt(vel.x*vel.x + vel.y*vel.y);
@@ -30,7 +41,12 @@ void Ship::thrust(double power) {
     }
 }
 
-void Ship::update(double dt, int maxx, int maxy) {
+void Ship::update(double dt, int worldW, int worldH) {
+    prev = pos;
+#ifdef FIXED_POINT_PHYSICS
+    fixedFriction(vel);
+    fixedStep(pos, vel, dt, worldW, worldH);
+#else
     // aplicar friccion suave para simular espacio vacío 
     vel.x *= 0.99;
     vel.y *= 0.99;
@@ -38,27 +54,12 @@ void Ship::update(double dt, int maxx, int maxy) {
     pos.x += vel.x * dt;
     pos.y += vel.y * dt;
 
-    pos.x = fmod(pos.x, (double)maxx);
-    if (pos.x < 0) pos.x += (double)maxx;
-    
-    double y_min = 1.0;
-    double y_range = (double)(maxy - 1);
-    pos.y = y_min + fmod(pos.y - y_min, y_range);
-    if (pos.y < y_min) pos.y += y_range;
+    wrapPosition(pos, worldW, worldH);
+#endif
 }
 
 char Ship::glyph() const {
-    double a = angle;
-    double pi2 = M_PI/2.0;
-    
-    // normalizar angulo a rango [-pi, pi]
-    while (a > M_PI) a -= 2*M_PI;
-    while (a < -M_PI) a += 2*M_PI;
-    
-    if (a >= -pi2/2 && a < pi2/2) return '>';
-    if (a >= pi2/2 && a < 3*pi2/2) return 'v';
-    if (a >= 3*pi2/2 || a < -3*pi2/2) return '<';
-    return '^';
+    return DIR_TABLES.glyph[dir];
 }
 
 std::string Ship::glyphStr() const {
@@ -69,6 +70,11 @@ std::string Ship::glyphStr() const {
 void Ship::reset(double x, double y) {
     pos.x = x; 
     pos.y = y;
+    prev = pos;
     vel.x = vel.y = 0;
-    angle = -M_PI/2;
+    dir = SHIP_START_DIR;
+}
+
+PackedBody Ship::pack(int id) const {
+    return packBody(pos, vel, BODY_SHIP, id, dir);
 }
\ No newline at end of file
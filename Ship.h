@@ -5,27 +5,41 @@
 #include <string>
 #include <atomic>
 
+struct PackedBody;
+
 struct Vec2 {
     double x = 0.0, y = 0.0;
 };
 
+// envuelve una posicion al mundo toroidal [0, w) x [0, h)
+inline void wrapPosition(Vec2& p, int w, int h) {
+    p.x = fmod(p.x, (double)w);
+    if (p.x < 0) p.x += (double)w;
+    p.y = fmod(p.y, (double)h);
+    if (p.y < 0) p.y += (double)h;
+}
+
 class Ship {
 public:
     Vec2 pos;
+    Vec2 prev; // posicion del tick anterior (para interpolar al dibujar)
     Vec2 vel;
-    double angle; // radianes (0 = derecha, pi/2 = abajo, -pi/2 = arriba)
+    int dir; // rumbo discreto 0..SHIP_DIRS-1 (0 = derecha, 5 = abajo, 15 = arriba), ver Trig.h
     std::atomic<int> lives;  // Cambiar a atomic
     std::atomic<int> score;  // Cambiar a atomic
 
     Ship(double x = 0.0, double y = 0.0);
     
-    void rotateLeft(double delta);
-    void rotateRight(double delta);
+    void rotateLeft();  // un paso de direccion
+    void rotateRight();
+    double dirX() const; // coseno del rumbo (tabla)
+    double dirY() const; // seno del rumbo (tabla)
     void thrust(double power);
-    void update(double dt, int maxx, int maxy);
+    void update(double dt, int worldW, int worldH);
     char glyph() const;
     std::string glyphStr() const;
     void reset(double x, double y);
+    PackedBody pack(int id) const; // registro compacto de 16 bytes
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,186 @@
+#include "Snapshot.h"
+#include <cstring>
+#include <type_traits>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static const uint32_t SNAPSHOT_MAGIC = 0x53545341; // "ASTS"
+// subir si cambia el layout de SnapshotHeader, Asteroid o Projectile
+static const uint32_t SNAPSHOT_VERSION = 1;
+
+static_assert(std::is_trivially_copyable<Asteroid>::value, "Asteroid se guarda con memcpy");
+static_assert(std::is_trivially_copyable<Projectile>::value, "Projectile se guarda con memcpy");
+
+// FNV-1a de a 8 bytes (la foto se arma con los locks tomados: byte a byte costaba mas que el memcpy)
+static uint32_t fnv(const char* p, size_t n) {
+    uint64_t h = 14695981039346656037ull;
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        uint64_t w;
+        memcpy(&w, p + i, 8);
+        h ^= w;
+        h *= 1099511628211ull;
+    }
+    for (; i < n; ++i) {
+        h ^= (uint8_t)p[i];
+        h *= 1099511628211ull;
+    }
+    return (uint32_t)(h ^ (h >> 32));
+}
+
+void Snapshot::encode(std::string& out, SnapshotHeader hdr,
+                      const std::vector<Asteroid>& asteroids, const std::vector<Projectile>& bullets) {
+    size_t astBytes = asteroids.size() * sizeof(Asteroid);
+    size_t bulBytes = bullets.size() * sizeof(Projectile);
+    out.resize(sizeof(hdr) + astBytes + bulBytes);
+
+    char* p = &out[0] + sizeof(hdr);
+    if (astBytes) memcpy(p, asteroids.data(), astBytes);
+    if (bulBytes) memcpy(p + astBytes, bullets.data(), bulBytes);
+
+    hdr.magic = SNAPSHOT_MAGIC;
+    hdr.version = SNAPSHOT_VERSION;
+    hdr.asteroidCount = (uint32_t)asteroids.size();
+    hdr.bulletCount = (uint32_t)bullets.size();
+    hdr.payloadSum = fnv(p, astBytes + bulBytes);
+    memcpy(&out[0], &hdr, sizeof(hdr));
+}
+
+bool Snapshot::decode(const std::string& in, SnapshotHeader& hdr,
+                      std::vector<Asteroid>& asteroids, std::vector<Projectile>& bullets) {
+    if (in.size() < sizeof(hdr)) return false;
+    memcpy(&hdr, in.data(), sizeof(hdr));
+    if (hdr.magic != SNAPSHOT_MAGIC || hdr.version != SNAPSHOT_VERSION) return false;
+
+    size_t astBytes = (size_t)hdr.asteroidCount * sizeof(Asteroid);
+    size_t bulBytes = (size_t)hdr.bulletCount * sizeof(Projectile);
+    if (in.size() != sizeof(hdr) + astBytes + bulBytes) return false;
+    const char* p = in.data() + sizeof(hdr);
+    if (fnv(p, astBytes + bulBytes) != hdr.payloadSum) return false;
+    if (hdr.worldW <= 8 || hdr.worldH <= 4 || hdr.mode < 1 || hdr.mode > 3) return false;
+
+    // sin constructor por defecto: se redimensiona con un valor cualquiera y se pisa entero
+    asteroids.assign(hdr.asteroidCount, Asteroid(0, 0, 0, 0, 1));
+    bullets.assign(hdr.bulletCount, Projectile(0, 0, 0, 0));
+    if (astBytes) memcpy((void*)asteroids.data(), p, astBytes);
+    if (bulBytes) memcpy((void*)bullets.data(), p + astBytes, bulBytes);
+    return true;
+}
+
+bool Snapshot::load(const std::string& path, std::string& out) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    bool ok = fstat(fd, &st) == 0 && st.st_size > 0;
+    if (ok) {
+        out.resize(st.st_size);
+        ok = read(fd, &out[0], out.size()) == (ssize_t)out.size();
+    }
+    ::close(fd);
+    return ok;
+}
+
+void Snapshot::remove(const std::string& path) {
+    unlink(path.c_str());
+}
+
+SnapshotWriter::SnapshotWriter() : running(false), stopping(false), pending(false) {}
+
+SnapshotWriter::~SnapshotWriter() {
+    stop();
+}
+
+void SnapshotWriter::start(const std::string& path_) {
+    if (running) return;
+    path = path_;
+    stopping = false;
+    pending = false;
+    running = true;
+    pthread_create(&worker, NULL, workerThread, this);
+}
+
+void SnapshotWriter::stop() {
+    if (!running) return;
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        stopping = true;
+    }
+    cv.notify_all();
+    pthread_join(worker, NULL);
+    running = false;
+}
+
+void SnapshotWriter::submit(std::string& buf) {
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        data.swap(buf);
+        pending = true;
+    }
+    cv.notify_one();
+}
+
+void SnapshotWriter::flush() {
+    {
+        std::unique_lock<std::mutex> lock(mtx);
+        cv.wait(lock, [this]{ return !pending || !running; });
+    }
+    // el worker baja pending con mtxFile tomado: esperar a que suelte el archivo
+    std::lock_guard<std::mutex> lock(mtxFile);
+}
+
+void SnapshotWriter::discard() {
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        pending = false;
+    }
+    // si el hilo estaba escribiendo, el borrado espera a que termine el rename
+    std::lock_guard<std::mutex> lock(mtxFile);
+    Snapshot::remove(path);
+}
+
+bool SnapshotWriter::writeFile(const std::string& bytes) {
+    std::string tmp = path + ".tmp";
+    int fd = ::open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return false;
+    bool ok = write(fd, bytes.data(), bytes.size()) == (ssize_t)bytes.size() && fdatasync(fd) == 0;
+    ::close(fd);
+    // rename atomico: si se corta a mitad queda la foto anterior entera
+    if (!ok || rename(tmp.c_str(), path.c_str()) != 0) {
+        unlink(tmp.c_str());
+        return false;
+    }
+    return true;
+}
+
+void* SnapshotWriter::workerThread(void* arg) {
+    SnapshotWriter* w = (SnapshotWriter*)arg;
+    pthread_setname_np(pthread_self(), "ast-snapshot");
+    std::string local;
+
+    while (true) {
+        bool exiting;
+        {
+            std::unique_lock<std::mutex> lock(w->mtx);
+            w->cv.wait(lock, [w]{ return w->pending || w->stopping; });
+            exiting = w->stopping;
+        }
+        {
+            // la foto se toma con mtxFile ya tomado: un discard() en el medio
+            // o la anula antes o espera a que termine el rename y borra despues
+            std::lock_guard<std::mutex> lockFile(w->mtxFile);
+            bool have;
+            {
+                std::lock_guard<std::mutex> lock(w->mtx);
+                have = w->pending;
+                if (have) local.swap(w->data);
+                w->pending = false;
+            }
+            w->cv.notify_all(); // flush()
+            if (have) w->writeFile(local);
+        }
+        if (exiting) break;
+    }
+
+    return NULL;
+}
@@ -0,0 +1,79 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+#include <pthread.h>
+#include "Asteroid.h"
+#include "Projectile.h"
+
+// foto binaria de una partida en curso, para retomarla si el proceso se cae o se reinicia.
+// cabecera fija + los vectores de asteroides y balas copiados tal cual (memcpy), asi que
+// guardar y restaurar cuesta lo que copiar unos pocos KB
+
+struct SnapshotShip {
+    Vec2 pos, prev, vel;
+    int32_t dir, lives, score, pad;
+};
+
+struct SnapshotHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t payloadSum;   // FNV-1a de todo lo que sigue a la cabecera
+    int32_t mode, winScore;
+    int32_t worldW, worldH;
+    uint32_t asteroidTick;
+    uint64_t rngState;
+    uint32_t asteroidCount;
+    uint32_t bulletCount;
+    SnapshotShip ships[2];
+};
+
+namespace Snapshot {
+    // arma el archivo completo en out (reutiliza su memoria)
+    void encode(std::string& out, SnapshotHeader hdr,
+                const std::vector<Asteroid>& asteroids, const std::vector<Projectile>& bullets);
+    // false si la version, el tamaño o el checksum no coinciden
+    bool decode(const std::string& in, SnapshotHeader& hdr,
+                std::vector<Asteroid>& asteroids, std::vector<Projectile>& bullets);
+
+    bool load(const std::string& path, std::string& out);
+    void remove(const std::string& path);
+}
+
+// escribe las fotos en segundo plano (tmp + fdatasync + rename): el hilo del juego solo
+// entrega el buffer. si llegan varias antes de escribir, se guarda la ultima
+class SnapshotWriter {
+public:
+    SnapshotWriter();
+    ~SnapshotWriter();
+
+    void start(const std::string& path);
+    void stop(); // escribe lo pendiente y espera al hilo
+
+    // toma el contenido de buf (lo intercambia: buf queda con memoria para la proxima)
+    void submit(std::string& buf);
+    // espera a que la ultima foto entregada quede en disco
+    void flush();
+    // descarta lo pendiente y borra el archivo (partida terminada)
+    void discard();
+
+private:
+    static void* workerThread(void* arg);
+    bool writeFile(const std::string& data);
+
+    std::string path;
+    pthread_t worker;
+    bool running;
+    bool stopping;
+    bool pending;
+    std::mutex mtx;
+    std::mutex mtxFile; // serializa escritura y borrado del archivo
+    std::condition_variable cv;
+    std::string data;
+};
+
+#endif
@@ -0,0 +1,139 @@
+#include "Soak.h"
+#include <dirent.h>
+#include <unistd.h>
+#include <ctime>
+#include <cstring>
+#include <algorithm>
+#include <ncurses.h>
+
+// entradas de un directorio de /proc (sin . y ..)
+static int countEntries(const char* path) {
+    DIR* d = opendir(path);
+    if (!d) return -1;
+    int n = 0;
+    while (struct dirent* e = readdir(d)) {
+        if (e->d_name[0] != '.') n++;
+    }
+    closedir(d);
+    return n;
+}
+
+bool sampleProcess(ProcSample& out) {
+    FILE* f = fopen("/proc/self/statm", "r");
+    if (!f) return false;
+    long size = 0, resident = 0;
+    int ok = fscanf(f, "%ld %ld", &size, &resident);
+    fclose(f);
+    if (ok != 2) return false;
+    out.rssKb = resident * (sysconf(_SC_PAGESIZE) / 1024);
+    out.threads = countEntries("/proc/self/task");
+    out.fds = countEntries("/proc/self/fd") - 1; // el del propio opendir
+    return out.threads > 0 && out.fds >= 0;
+}
+
+SoakBot::SoakBot() : rng((uint64_t)time(NULL)), menuStep(0), endNs(0) {}
+
+void SoakBot::menuShown() {
+    menuStep = 0;
+}
+
+void SoakBot::matchStarted(int64_t nowNs, int seconds) {
+    endNs = nowNs + (int64_t)seconds * 1000000000LL;
+}
+
+int SoakBot::menuKey(int match, bool canResume) {
+    // con "Continuar partida" arriba Enter retoma el checkpoint: se prueban los dos caminos
+    int step = menuStep++;
+    if (step == 0) return '1' + match % 3;
+    if (step == 1 && canResume && match % 2 == 0) return KEY_DOWN;
+    return '\n';
+}
+
+int SoakBot::gameKey(int64_t nowNs, bool twoPlayers) {
+    if (nowNs >= endNs) return 'q'; // no termino sola: se corta (queda el checkpoint)
+    if (rng.range(4) != 0) return ERR; // ~1 tecla cada 4 lecturas
+    static const int P1[] = { 'a', 'd', 'w', ' ', ' ' };
+    static const int P2[] = { KEY_LEFT, KEY_RIGHT, KEY_UP, '\n', '\n' };
+    if (twoPlayers && rng.range(2)) return P2[rng.range(5)];
+    return P1[rng.range(5)];
+}
+
+void SoakMonitor::begin(int matches, const SoakBudget& b) {
+    target = matches;
+    budget = b;
+    played = 0;
+    breached = false;
+    why.clear();
+    memset(&base, 0, sizeof(base));
+    baseScores = 0;
+    peakRssKb = 0;
+    worstP99 = 0;
+    resetTicks();
+}
+
+void SoakMonitor::resetTicks() {
+    memset(hist, 0, sizeof(hist));
+    ticks = 0;
+}
+
+int SoakMonitor::p99Us() const {
+    if (ticks == 0) return 0;
+    uint64_t want = ticks * 99 / 100;
+    uint64_t acc = 0;
+    for (int b = 0; b <= BUCKETS; ++b) {
+        acc += hist[b];
+        if (acc > want) return (b + 1) * BUCKET_US; // borde superior del bucket
+    }
+    return (BUCKETS + 1) * BUCKET_US;
+}
+
+bool SoakMonitor::afterMatch(FILE* f, size_t entityCap, long scoresBytes) {
+    played++;
+    ProcSample s;
+    if (!sampleProcess(s)) {
+        breached = true;
+        why = "no se pudo leer /proc/self";
+        return false;
+    }
+    int p99 = p99Us();
+    resetTicks();
+    peakRssKb = std::max(peakRssKb, s.rssKb);
+    if (played == 1) { // calentamiento
+        base = s;
+        baseScores = scoresBytes;
+    }
+
+    char msg[128] = "";
+    if (played > 1) {
+        worstP99 = std::max(worstP99, p99);
+        if (s.rssKb - base.rssKb > budget.rssGrowthKb) {
+            snprintf(msg, sizeof(msg), "RSS crecio %ld KB (limite %ld)", s.rssKb - base.rssKb, budget.rssGrowthKb);
+        } else if (s.threads > base.threads + budget.extraThreads) {
+            snprintf(msg, sizeof(msg), "%d hilos vivos en el menu (base %d)", s.threads, base.threads);
+        } else if (s.fds > base.fds + budget.extraFds) {
+            snprintf(msg, sizeof(msg), "%d descriptores abiertos (base %d)", s.fds, base.fds);
+        } else if (p99 > budget.p99TickUs) {
+            snprintf(msg, sizeof(msg), "p99 del tick %dus (limite %dus)", p99, budget.p99TickUs);
+        } else if ((long)entityCap > budget.entityCap) {
+            snprintf(msg, sizeof(msg), "vectores de entidades con capacidad %zu (limite %ld)", entityCap, budget.entityCap);
+        } else if (scoresBytes - baseScores > budget.scoresPerMatchB * (played - 1)) {
+            snprintf(msg, sizeof(msg), "puntajes crecieron %ld bytes en %d partidas (limite %ld por partida)",
+                     scoresBytes - baseScores, played - 1, budget.scoresPerMatchB);
+        }
+    }
+    if (msg[0]) {
+        breached = true;
+        why = msg;
+    }
+
+    if (f) {
+        fprintf(f, "  soak %d/%d: rss=%ldKB hilos=%d fds=%d p99 tick<=%dus entidades(cap)=%zu puntajes=%ldB%s%s\n",
+                played, target, s.rssKb, s.threads, s.fds, p99, entityCap, scoresBytes,
+                breached ? " | FUERA DE PRESUPUESTO: " : "", breached ? why.c_str() : "");
+        if (breached || played >= target) {
+            fprintf(f, "  soak fin: %d partidas, RSS base=%ldKB pico=%ldKB, peor p99=%dus -> %s\n",
+                    played, base.rssKb, peakRssKb, worstP99, breached ? "FALLO" : "OK");
+        }
+    }
+    return !breached && played < target;
+}
@@ -0,0 +1,82 @@
+#ifndef SOAK_H
+#define SOAK_H
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include "Rng.h"
+#include "SoakBudget.h"
+
+// modo de prueba larga (--soak N): un bot juega N partidas seguidas por el camino completo
+// menu -> startGame -> pantalla final -> puntajes, y despues de cada una se mide el proceso.
+// la primera partida es de calentamiento (ncurses, indices, pools): sus valores son la base.
+// si algo se pasa del presupuesto se corta y el proceso sale con error
+
+// estado del proceso, leido de /proc/self
+struct ProcSample {
+    long rssKb;
+    int threads;
+    int fds;
+};
+
+bool sampleProcess(ProcSample& out);
+
+// teclas del bot (hilo del menu / inputThread / pantalla final, nunca a la vez)
+class SoakBot {
+public:
+    SoakBot();
+    void menuShown();
+    void matchStarted(int64_t nowNs, int seconds);
+    // modo (1/2/3 rotando) y despues Enter. si hay checkpoint alterna: las partidas pares bajan
+    // a "Iniciar partida" y las impares retoman
+    int menuKey(int match, bool canResume);
+    int gameKey(int64_t nowNs, bool twoPlayers); // teclas al azar; Q al pasar el limite
+
+private:
+    Rng rng;
+    int menuStep;
+    int64_t endNs;
+};
+
+class SoakMonitor {
+public:
+    static const int BUCKET_US = 100;
+    static const int BUCKETS = 500; // hasta 50 ms; el ultimo junta el resto
+
+    SoakMonitor() : target(0), played(0), breached(false) { resetTicks(); }
+
+    void begin(int matches, const SoakBudget& b);
+    bool active() const { return target > 0; }
+    int matches() const { return played; }
+    SoakBudget budget;
+
+    // updateThread (uno por partida; se lee despues del join)
+    void tickCost(int64_t ns) {
+        int b = (int)(ns / (BUCKET_US * 1000));
+        hist[b < BUCKETS ? b : BUCKETS]++;
+        ticks++;
+    }
+
+    // despues de cada partida: mide, anota una linea en f y controla el presupuesto.
+    // entityCap = capacidad de los vectores de entidades, scoresBytes = tamaño del almacen de puntajes.
+    // devuelve false si hay que terminar (se llego a N o se paso un limite)
+    bool afterMatch(FILE* f, size_t entityCap, long scoresBytes);
+    bool failed() const { return breached; }
+    const std::string& breach() const { return why; }
+
+private:
+    void resetTicks();
+    int p99Us() const;
+
+    int target, played;
+    bool breached;
+    std::string why;
+    ProcSample base;
+    long baseScores;
+    long peakRssKb;
+    int worstP99;
+    uint32_t hist[BUCKETS + 1];
+    uint64_t ticks;
+};
+
+#endif
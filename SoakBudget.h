@@ -0,0 +1,18 @@
+#ifndef SOAKBUDGET_H
+#define SOAKBUDGET_H
+
+// aparte de Soak.h para que ThreadConfig lo pueda leer de asteroids.conf sin depender del bot
+
+// presupuesto (asteroids.conf: soak_rss_kb, soak_threads, soak_fds, soak_p99_us, soak_match_s,
+// soak_entities, soak_scores_b)
+struct SoakBudget {
+    long rssGrowthKb = 65536; // crecimiento de RSS sobre la base
+    int extraThreads = 0;     // hilos de mas en el menu respecto de la base
+    int extraFds = 2;         // descriptores de mas respecto de la base
+    int p99TickUs = 16500;    // p99 del costo de un tick (la mitad del periodo)
+    int matchSeconds = 20;    // el bot sale con Q si la partida no termino antes
+    long entityCap = 4096;    // capacidad sumada de los vectores de entidades
+    long scoresPerMatchB = 1024; // crecimiento de scores.idx/.log/.journal por partida (promedio)
+};
+
+#endif
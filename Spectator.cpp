@@ -0,0 +1,292 @@
+#include "Spectator.h"
+#include <ncurses.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <cstdio>
+#include <chrono>
+
+static const uint32_t FRAME_MAGIC = 0x56545341; // "ASTV"
+// un tramo cuesta 6 bytes de cabecera: huecos menores a esto se mandan dentro del tramo
+static const int MERGE_GAP = 3;
+// un espectador con mas de esto sin leer se desconecta
+static const size_t MAX_BACKLOG = 1 << 20;
+
+static bool makeAddr(const std::string& path, sockaddr_un& addr) {
+    if (path.empty() || path.size() >= sizeof(addr.sun_path)) return false;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    memcpy(addr.sun_path, path.c_str(), path.size());
+    return true;
+}
+
+static void put16(std::string& s, uint16_t v) {
+    s.append((const char*)&v, sizeof(v));
+}
+
+SpectatorServer::SpectatorServer()
+: listenFd(-1), running(false), stopping(false), clientCount(0),
+  mailW(0), mailH(0), fresh(false), curW(0), curH(0), seq(0) {}
+
+SpectatorServer::~SpectatorServer() {
+    stop();
+}
+
+bool SpectatorServer::start(const std::string& path_) {
+    if (running) return true;
+    sockaddr_un addr;
+    if (!makeAddr(path_, addr)) return false;
+
+    listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0);
+    if (listenFd < 0) return false;
+    unlink(path_.c_str());
+    if (bind(listenFd, (sockaddr*)&addr, sizeof(addr)) != 0 || listen(listenFd, 16) != 0) {
+        close(listenFd);
+        listenFd = -1;
+        return false;
+    }
+    path = path_;
+    stopping = false;
+    running = true;
+    pthread_create(&worker, NULL, workerThread, this);
+    return true;
+}
+
+void SpectatorServer::stop() {
+    if (!running) return;
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        stopping = true;
+    }
+    cv.notify_all();
+    pthread_join(worker, NULL);
+    running = false;
+
+    for (auto &c : clients) {
+        if (c.fd >= 0) close(c.fd);
+    }
+    clients.clear();
+    clientCount = 0;
+    close(listenFd);
+    listenFd = -1;
+    unlink(path.c_str());
+}
+
+void SpectatorServer::publish(int w, int h) {
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        mailbox.swap(capture);
+        mailW = w;
+        mailH = h;
+        fresh = true;
+    }
+    cv.notify_one();
+}
+
+void SpectatorServer::acceptClients() {
+    while (true) {
+        int fd = accept4(listenFd, NULL, NULL, SOCK_NONBLOCK);
+        if (fd < 0) break;
+        clients.push_back(Client{ fd, true, std::string() });
+    }
+}
+
+// tramos de celdas distintas al cuadro anterior (o todas si key)
+void SpectatorServer::encode(const std::vector<uint16_t>& cur, bool key, std::string& msg) {
+    msg.assign(sizeof(SpectatorFrameHeader), '\0');
+    uint16_t runs = 0;
+    for (int y = 0; y < curH; ++y) {
+        const uint16_t* row = &cur[(size_t)y * curW];
+        const uint16_t* old = key ? NULL : &previous[(size_t)y * curW];
+        int x = 0;
+        while (x < curW) {
+            if (!key && row[x] == old[x]) { x++; continue; }
+            int start = x;
+            int end = ++x;
+            while (x < curW) {
+                if (key || row[x] != old[x]) end = ++x;
+                else if (x - end < MERGE_GAP) x++;
+                else break;
+            }
+            put16(msg, (uint16_t)y);
+            put16(msg, (uint16_t)start);
+            put16(msg, (uint16_t)(end - start));
+            msg.append((const char*)(row + start), (end - start) * sizeof(uint16_t));
+            runs++;
+        }
+    }
+
+    SpectatorFrameHeader hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    hdr.magic = FRAME_MAGIC;
+    hdr.seq = seq;
+    hdr.w = (uint16_t)curW;
+    hdr.h = (uint16_t)curH;
+    hdr.flags = key ? SPECTATOR_KEYFRAME : 0;
+    hdr.runs = runs;
+    hdr.payloadBytes = (uint32_t)(msg.size() - sizeof(hdr));
+    memcpy(&msg[0], &hdr, sizeof(hdr));
+}
+
+void SpectatorServer::flushClient(Client& c) {
+    while (c.fd >= 0 && !c.out.empty()) {
+        ssize_t n = send(c.fd, c.out.data(), c.out.size(), MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (n > 0) {
+            c.out.erase(0, n);
+        } else if (n < 0 && errno == EINTR) {
+            continue;
+        } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break; // socket lleno: lo que falta sale en la proxima vuelta
+        } else {
+            close(c.fd);
+            c.fd = -1;
+        }
+    }
+    if (c.fd >= 0 && c.out.size() > MAX_BACKLOG) {
+        close(c.fd);
+        c.fd = -1;
+    }
+}
+
+void* SpectatorServer::workerThread(void* arg) {
+    SpectatorServer* s = (SpectatorServer*)arg;
+    pthread_setname_np(pthread_self(), "ast-spectate");
+    std::string keyMsg, deltaMsg;
+
+    while (true) {
+        bool have = false;
+        {
+            std::unique_lock<std::mutex> lock(s->mtx);
+            // despierta por cuadro nuevo, o cada tanto para aceptar espectadores
+            s->cv.wait_for(lock, std::chrono::milliseconds(50), [s]{ return s->fresh || s->stopping; });
+            if (s->stopping) break;
+            if (s->fresh) {
+                s->current.swap(s->mailbox);
+                if (s->mailW != s->curW || s->mailH != s->curH) s->previous.clear();
+                have = true;
+                s->curW = s->mailW;
+                s->curH = s->mailH;
+                s->fresh = false;
+            }
+        }
+
+        s->acceptClients();
+
+        if (have && s->current.size() == (size_t)s->curW * s->curH) {
+            // primer cuadro o cambio de tamaño: no hay cuadro anterior con que comparar
+            bool resized = s->previous.size() != s->current.size();
+            bool needKey = resized, needDelta = false;
+            for (auto &c : s->clients) {
+                if (c.needKey) needKey = true;
+                else needDelta = true;
+            }
+            s->seq++;
+            if (needKey) s->encode(s->current, true, keyMsg);
+            if (needDelta && !resized) s->encode(s->current, false, deltaMsg);
+            for (auto &c : s->clients) {
+                c.out += (c.needKey || resized) ? keyMsg : deltaMsg;
+                c.needKey = false;
+            }
+            s->previous.swap(s->current);
+        }
+
+        for (auto &c : s->clients) s->flushClient(c);
+        size_t k = 0;
+        for (size_t i = 0; i < s->clients.size(); ++i) {
+            if (s->clients[i].fd < 0) continue;
+            if (i != k) s->clients[k] = std::move(s->clients[i]);
+            k++;
+        }
+        s->clients.resize(k);
+        s->clientCount = (int)k;
+    }
+
+    return NULL;
+}
+
+//============================================================================
+// CLIENTE
+//============================================================================
+
+static bool readAll(int fd, void* buf, size_t len) {
+    char* p = (char*)buf;
+    while (len > 0) {
+        ssize_t n = read(fd, p, len);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        p += n;
+        len -= n;
+    }
+    return true;
+}
+
+int runSpectatorClient(const std::string& path) {
+    sockaddr_un addr;
+    if (!makeAddr(path, addr)) return 1;
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0 || connect(fd, (sockaddr*)&addr, sizeof(addr)) != 0) {
+        fprintf(stderr, "no se pudo conectar a %s\n", path.c_str());
+        if (fd >= 0) close(fd);
+        return 1;
+    }
+
+    initscr();
+    cbreak();
+    noecho();
+    curs_set(0);
+    nodelay(stdscr, TRUE);
+    if (has_colors()) {
+        start_color();
+        use_default_colors();
+        init_pair(1, COLOR_CYAN, -1);
+        init_pair(2, COLOR_GREEN, -1);
+        init_pair(3, COLOR_YELLOW, -1);
+        init_pair(4, COLOR_WHITE, -1);
+    }
+    mvprintw(0, 0, "Espectador: esperando una partida en %s (Q sale)", path.c_str());
+    refresh();
+
+    std::string payload;
+    bool ok = true;
+    while (ok) {
+        int ch = getch();
+        if (ch == 'q' || ch == 'Q') break;
+
+        pollfd pf = { fd, POLLIN, 0 };
+        if (poll(&pf, 1, 50) <= 0) continue;
+
+        SpectatorFrameHeader hdr;
+        if (!readAll(fd, &hdr, sizeof(hdr)) || hdr.magic != FRAME_MAGIC) break;
+        payload.resize(hdr.payloadBytes);
+        if (hdr.payloadBytes > 0 && !readAll(fd, &payload[0], hdr.payloadBytes)) break;
+
+        if (hdr.flags & SPECTATOR_KEYFRAME) erase();
+        size_t off = 0;
+        for (int r = 0; r < hdr.runs && ok; ++r) {
+            uint16_t rh[3];
+            if (off + sizeof(rh) > payload.size()) { ok = false; break; }
+            memcpy(rh, &payload[off], sizeof(rh));
+            off += sizeof(rh);
+            if (off + rh[2] * sizeof(uint16_t) > payload.size()) { ok = false; break; }
+            for (int i = 0; i < rh[2]; ++i) {
+                uint16_t cell;
+                memcpy(&cell, &payload[off + i * sizeof(uint16_t)], sizeof(cell));
+                chtype c = (cell & CELL_CHAR);
+                if (has_colors() && (cell & CELL_PAIR)) c |= COLOR_PAIR((cell & CELL_PAIR) >> 8);
+                if (cell & CELL_BOLD) c |= A_BOLD;
+                if (cell & CELL_REVERSE) c |= A_REVERSE;
+                mvaddch(rh[0], rh[1] + i, c); // fuera de esta terminal: ncurses lo ignora
+            }
+            off += rh[2] * sizeof(uint16_t);
+        }
+        refresh();
+    }
+
+    endwin();
+    close(fd);
+    return 0;
+}
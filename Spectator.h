@@ -0,0 +1,90 @@
+#ifndef SPECTATOR_H
+#define SPECTATOR_H
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <cstdint>
+#include <pthread.h>
+
+// transmision de la partida a espectadores por un socket Unix.
+// drawThread copia la pantalla ya dibujada (una celda = uint16) y la deja en un buzon;
+// un hilo aparte la compara con el cuadro anterior y manda solo las celdas que cambiaron.
+// el dibujo nunca espera al socket: si el hilo se atrasa se salta cuadros, y a un
+// espectador que no lee se lo desconecta
+
+// celda: bits 0-7 caracter, 8-11 color, 12 negrita, 13 inverso
+enum SpectatorCellBits : uint16_t {
+    CELL_CHAR    = 0x00ff,
+    CELL_PAIR    = 0x0f00,
+    CELL_BOLD    = 0x1000,
+    CELL_REVERSE = 0x2000
+};
+
+// cabecera de cada cuadro; le siguen payloadBytes de tramos {y, x, len, celdas[len]} (uint16)
+struct SpectatorFrameHeader {
+    uint32_t magic;
+    uint32_t seq;
+    uint16_t w, h;
+    uint16_t flags;    // SPECTATOR_KEYFRAME = cuadro completo
+    uint16_t runs;
+    uint32_t payloadBytes;
+};
+
+static const uint16_t SPECTATOR_KEYFRAME = 1;
+
+class SpectatorServer {
+public:
+    SpectatorServer();
+    ~SpectatorServer();
+
+    bool start(const std::string& path);
+    void stop();
+
+    // true si vale la pena capturar la pantalla (hay alguien mirando)
+    bool wanted() const { return clientCount.load() > 0; }
+
+    // buffer donde drawThread copia la pantalla antes de publish()
+    std::vector<uint16_t>& captureBuffer() { return capture; }
+    // entrega el cuadro al hilo de envio (intercambio de buffers, sin copiar ni IO)
+    void publish(int w, int h);
+
+private:
+    struct Client {
+        int fd;
+        bool needKey;       // recien conectado: primero un cuadro completo
+        std::string out;    // bytes pendientes de enviar
+    };
+
+    static void* workerThread(void* arg);
+    void acceptClients();
+    void encode(const std::vector<uint16_t>& cur, bool key, std::string& msg);
+    void flushClient(Client& c);
+
+    std::string path;
+    int listenFd;
+    pthread_t worker;
+    bool running;
+    bool stopping;
+    std::atomic<int> clientCount;
+
+    std::mutex mtx;
+    std::condition_variable cv;
+    std::vector<uint16_t> capture; // solo drawThread
+    std::vector<uint16_t> mailbox; // protegido por mtx
+    int mailW, mailH;
+    bool fresh;
+
+    // estado del hilo de envio
+    std::vector<uint16_t> current, previous;
+    int curW, curH;
+    uint32_t seq;
+    std::vector<Client> clients;
+};
+
+// cliente: se conecta a una partida y la dibuja en esta terminal (Q sale)
+int runSpectatorClient(const std::string& path);
+
+#endif
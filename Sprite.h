@@ -0,0 +1,90 @@
+#ifndef SPRITE_H
+#define SPRITE_H
+
+#include <cstdint>
+
+// sprites ASCII de varias celdas para los asteroides.
+// cada fila tiene una mascara de bits (bit x = celda ocupada) calculada en compilacion;
+// la prueba fina de colision es un AND de palabras por fila, despues de que el
+// circulo (broad-phase) ya descarto casi todo
+
+static const int SPRITE_MAX_H = 8; // ancho maximo 64 (una palabra por fila)
+
+struct Sprite {
+    int w, h;
+    int cx, cy; // celda ancla (coincide con la posicion de la entidad)
+    const char* rows[SPRITE_MAX_H];
+    uint64_t mask[SPRITE_MAX_H];
+};
+
+// la mascara rellena cada fila entre el primer y el ultimo caracter no vacio:
+// el interior del asteroide tambien es solido
+constexpr Sprite makeSprite(const char* const* rows, int h) {
+    Sprite s{};
+    s.h = h;
+    for (int y = 0; y < h; ++y) {
+        s.rows[y] = rows[y];
+        int first = -1, last = -1, len = 0;
+        for (const char* c = rows[y]; *c; ++c, ++len) {
+            if (*c != ' ') {
+                if (first < 0) first = len;
+                last = len;
+            }
+        }
+        if (len > s.w) s.w = len;
+        for (int x = first; first >= 0 && x <= last; ++x) s.mask[y] |= (uint64_t)1 << x;
+    }
+    s.cx = s.w / 2;
+    s.cy = h / 2;
+    return s;
+}
+
+constexpr const char* AST_SMALL[] = {
+    "o"
+};
+constexpr const char* AST_MEDIUM[] = {
+    " .-. ",
+    "(   )",
+    " '-' "
+};
+constexpr const char* AST_LARGE[] = {
+    "  .---.  ",
+    " /     \\ ",
+    "(       )",
+    " \\     / ",
+    "  '---'  "
+};
+
+// indexado por Asteroid::size (1 = pequeño, 2 = mediano, 3 = grande)
+inline constexpr Sprite ASTEROID_SPRITES[4] = {
+    makeSprite(AST_SMALL, 1),
+    makeSprite(AST_SMALL, 1),
+    makeSprite(AST_MEDIUM, 3),
+    makeSprite(AST_LARGE, 5)
+};
+
+// ¿la celda (px, py), relativa al ancla del sprite, esta ocupada?
+inline bool spriteHasCell(const Sprite& s, int px, int py) {
+    int x = px + s.cx;
+    int y = py + s.cy;
+    if (x < 0 || x >= s.w || y < 0 || y >= s.h) return false;
+    return (s.mask[y] >> x) & 1;
+}
+
+// ¿se tocan dos sprites? (dx, dy) = ancla de b menos ancla de a, en celdas
+inline bool spritesOverlap(const Sprite& a, const Sprite& b, int dx, int dy) {
+    // esquina de b relativa a la esquina de a
+    int ox = dx + a.cx - b.cx;
+    int oy = dy + a.cy - b.cy;
+    if (ox >= a.w || -ox >= b.w) return false;
+    int y0 = oy > 0 ? oy : 0;
+    int y1 = (oy + b.h < a.h) ? oy + b.h : a.h;
+    for (int y = y0; y < y1; ++y) {
+        uint64_t bm = b.mask[y - oy];
+        uint64_t shifted = (ox >= 0) ? (bm << ox) : (bm >> -ox);
+        if (a.mask[y] & shifted) return true;
+    }
+    return false;
+}
+
+#endif
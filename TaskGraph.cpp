@@ -0,0 +1,167 @@
+#include "TaskGraph.h"
+#include <sched.h>
+
+static const int SPIN_TRIES = 32; // vueltas con sched_yield antes de dormir
+
+int TaskGraph::add(const char* name, std::function<void()> fn) {
+    nodes.emplace_back();
+    nodes.back().name = name;
+    nodes.back().fn = std::move(fn);
+    return (int)nodes.size() - 1;
+}
+
+void TaskGraph::depend(int task, int before) {
+    nodes[before].next.push_back(task);
+    nodes[task].deps++;
+}
+
+struct WorkerArg {
+    TaskPool* pool;
+    int index;
+};
+
+TaskPool::TaskPool() : graph(nullptr), remaining(0), generation(0), stopping(false), progress(0), sleepers(0) {}
+
+TaskPool::~TaskPool() {
+    stop();
+}
+
+void TaskPool::start(int workers, std::function<void(int)> init) {
+    if (!threads.empty()) return;
+    initFn = std::move(init);
+    stopping = false;
+    queues.clear();
+    queues.resize(workers + 1);
+    threads.resize(workers);
+    for (int i = 0; i < workers; ++i) {
+        pthread_create(&threads[i], NULL, workerThread, new WorkerArg{ this, i });
+    }
+}
+
+void TaskPool::stop() {
+    if (threads.empty()) return;
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        stopping = true;
+    }
+    cv.notify_all();
+    for (auto &t : threads) pthread_join(t, NULL);
+    threads.clear();
+}
+
+void TaskPool::run(TaskGraph& g) {
+    if (g.nodes.empty()) return;
+    int self = workers(); // cola del hilo que llama
+
+    for (auto &n : g.nodes) n.pending.store(n.deps, std::memory_order_relaxed);
+    graph = &g;
+    remaining.store((int)g.nodes.size(), std::memory_order_release);
+    {
+        std::lock_guard<std::mutex> lock(queues[self].mtx);
+        for (int i = 0; i < (int)g.nodes.size(); ++i) {
+            if (g.nodes[i].deps == 0) queues[self].q.push_back(i);
+        }
+    }
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        generation++;
+    }
+    cv.notify_all();
+
+    workLoop(self);
+}
+
+// toma de la propia cola por atras (LIFO) o roba por adelante de las demas
+bool TaskPool::popOrSteal(int self, int& task) {
+    {
+        Queue &own = queues[self];
+        std::lock_guard<std::mutex> lock(own.mtx);
+        if (!own.q.empty()) {
+            task = own.q.back();
+            own.q.pop_back();
+            return true;
+        }
+    }
+    int n = (int)queues.size();
+    for (int k = 1; k < n; ++k) {
+        Queue &other = queues[(self + k) % n];
+        std::lock_guard<std::mutex> lock(other.mtx);
+        if (!other.q.empty()) {
+            task = other.q.front();
+            other.q.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void TaskPool::execute(int self, int task) {
+    TaskGraph::Node &node = graph->nodes[task];
+    node.fn();
+    // las que quedaron listas van a la cola propia: las toma este hilo o las roba otro
+    bool released = false;
+    for (int s : node.next) {
+        if (graph->nodes[s].pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            std::lock_guard<std::mutex> lock(queues[self].mtx);
+            queues[self].q.push_back(s);
+            released = true;
+        }
+    }
+    bool last = remaining.fetch_sub(1, std::memory_order_acq_rel) == 1;
+    if (released || last) wake();
+}
+
+// progress se escribe antes de mirar sleepers y el que duerme hace lo contrario (los dos
+// seq_cst): o el que despierta ve al que duerme, o el que duerme ve el progreso y no se duerme
+void TaskPool::wake() {
+    progress.fetch_add(1);
+    if (sleepers.load() > 0) {
+        { std::lock_guard<std::mutex> lock(waitMtx); }
+        waitCv.notify_all();
+    }
+}
+
+void TaskPool::workLoop(int self) {
+    int idle = 0;
+    while (remaining.load(std::memory_order_acquire) > 0) {
+        unsigned seen = progress.load();
+        int task;
+        if (popOrSteal(self, task)) {
+            execute(self, task);
+            idle = 0;
+            continue;
+        }
+        // hay tareas corriendo que todavia no liberaron a otras: un rato se gira, despues se duerme
+        if (++idle < SPIN_TRIES) {
+            sched_yield();
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(waitMtx);
+        sleepers.fetch_add(1);
+        waitCv.wait(lock, [&]{ return progress.load() != seen || remaining.load() == 0; });
+        sleepers.fetch_sub(1);
+        idle = 0;
+    }
+}
+
+void* TaskPool::workerThread(void* arg) {
+    WorkerArg* wa = (WorkerArg*)arg;
+    TaskPool* pool = wa->pool;
+    int self = wa->index;
+    delete wa;
+
+    if (pool->initFn) pool->initFn(self);
+
+    unsigned seen = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(pool->mtx);
+            pool->cv.wait(lock, [&]{ return pool->stopping || pool->generation != seen; });
+            if (pool->stopping) break;
+            seen = pool->generation;
+        }
+        pool->workLoop(self);
+    }
+
+    return NULL;
+}
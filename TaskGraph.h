@@ -0,0 +1,84 @@
+#ifndef TASKGRAPH_H
+#define TASKGRAPH_H
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <vector>
+#include <pthread.h>
+
+// trabajo de un tick declarado como grafo: cada tarea corre apenas terminan las que
+// necesita, y las independientes corren en paralelo en el TaskPool
+
+class TaskGraph {
+public:
+    // devuelve el id de la tarea
+    int add(const char* name, std::function<void()> fn);
+    // task no empieza hasta que termine before
+    void depend(int task, int before);
+    void clear() { nodes.clear(); }
+    size_t size() const { return nodes.size(); }
+
+private:
+    friend class TaskPool;
+    struct Node {
+        const char* name;
+        std::function<void()> fn;
+        std::vector<int> next;
+        int deps = 0;
+        std::atomic<int> pending{0};
+    };
+    std::deque<Node> nodes; // deque: Node no se puede mover (atomic)
+};
+
+// pool con una cola por hilo: cada uno toma de la suya (la ultima tarea liberada, que
+// suele tocar los mismos datos) y si se queda sin trabajo roba de las otras
+class TaskPool {
+public:
+    TaskPool();
+    ~TaskPool();
+
+    // init corre al arrancar cada trabajador (nombre, afinidad)
+    void start(int workers, std::function<void(int)> init);
+    void stop();
+
+    // ejecuta el grafo completo y vuelve cuando termino; el hilo que llama tambien trabaja
+    void run(TaskGraph& g);
+
+    int workers() const { return (int)threads.size(); }
+
+private:
+    struct Queue {
+        std::mutex mtx;
+        std::deque<int> q;
+    };
+
+    static void* workerThread(void* arg);
+    void workLoop(int self);
+    bool popOrSteal(int self, int& task);
+    void execute(int self, int task);
+    void wake();
+
+    std::vector<pthread_t> threads;
+    std::deque<Queue> queues; // workers() + 1 (la ultima es del hilo que llama a run)
+    std::function<void(int)> initFn;
+
+    TaskGraph* graph;
+    std::atomic<int> remaining;
+    std::mutex mtx;
+    std::condition_variable cv;
+    unsigned generation; // sube con cada run (protegido por mtx)
+    bool stopping;
+
+    // hilos sin trabajo en medio de un run: despues de unas vueltas duermen aca hasta que
+    // se libere una tarea o termine el grafo (con SCHED_FIFO en un solo nucleo girar no deja
+    // correr a nadie de menor prioridad)
+    std::mutex waitMtx;
+    std::condition_variable waitCv;
+    std::atomic<unsigned> progress; // sube con cada tarea liberada o al terminar el grafo
+    std::atomic<int> sleepers;
+};
+
+#endif
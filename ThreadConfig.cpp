@@ -0,0 +1,132 @@
+#include "ThreadConfig.h"
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#include <cmath>
+#include <cstring>
+#include <cerrno>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+static const char* GROUP_NAMES[TG_COUNT] = { "sim", "render", "input" };
+
+static std::string trim(const std::string& s) {
+    size_t a = s.find_first_not_of(" \t\r");
+    if (a == std::string::npos) return "";
+    size_t b = s.find_last_not_of(" \t\r");
+    return s.substr(a, b - a + 1);
+}
+
+bool RuntimeConfig::load(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) return false;
+
+    std::string line;
+    while (std::getline(in, line)) {
+        line = trim(line.substr(0, line.find('#')));
+        size_t eq = line.find('=');
+        if (eq == std::string::npos) continue;
+        std::string key = trim(line.substr(0, eq));
+        std::string val = trim(line.substr(eq + 1));
+
+        bool on = (val == "1" || val == "on" || val == "true");
+        if (key == "jitter_report") { jitterReport = on; continue; }
+        if (key == "latency_report") { latencyReport = on; continue; }
+        if (key == "latency_target_ms") { latencyTargetMs = atoi(val.c_str()); continue; }
+        if (key == "stats_report") { statsReport = on; continue; }
+        if (key == "event_log") { eventLog = val; continue; }
+        if (key == "particles") { particleBudget = atoi(val.c_str()); continue; }
+        if (key == "adaptive") { adaptive = on; continue; }
+        if (key == "soak_rss_kb") { soak.rssGrowthKb = atol(val.c_str()); continue; }
+        if (key == "soak_threads") { soak.extraThreads = atoi(val.c_str()); continue; }
+        if (key == "soak_fds") { soak.extraFds = atoi(val.c_str()); continue; }
+        if (key == "soak_p99_us") { soak.p99TickUs = atoi(val.c_str()); continue; }
+        if (key == "soak_match_s") {
+            int v = atoi(val.c_str());
+            if (v > 0) soak.matchSeconds = v; // 0 o negativo: Q en el primer tick, se ignora
+            continue;
+        }
+        if (key == "soak_entities") { soak.entityCap = atol(val.c_str()); continue; }
+        if (key == "soak_scores_b") { soak.scoresPerMatchB = atol(val.c_str()); continue; }
+        size_t dot = key.find('.');
+        if (dot == std::string::npos) continue;
+        std::string group = key.substr(0, dot), field = key.substr(dot + 1);
+        for (int g = 0; g < TG_COUNT; ++g) {
+            if (group != GROUP_NAMES[g]) continue;
+            ThreadSettings &s = groups[g];
+            if (field == "cpu") s.cpu = atoi(val.c_str());
+            else if (field == "sched") s.fifo = (val == "fifo");
+            else if (field == "priority") s.priority = atoi(val.c_str());
+            else if (field == "nice") s.nice = atoi(val.c_str());
+        }
+    }
+    return true;
+}
+
+std::string RuntimeConfig::describe() const {
+    std::ostringstream os;
+    for (int g = 0; g < TG_COUNT; ++g) {
+        const ThreadSettings &s = groups[g];
+        if (g) os << "  ";
+        os << GROUP_NAMES[g] << ": cpu=";
+        if (s.cpu < 0) os << "*";
+        else os << s.cpu;
+        if (s.fifo) os << " fifo/" << s.priority;
+        if (s.nice) os << " nice=" << s.nice;
+    }
+    return os.str();
+}
+
+bool tuneCurrentThread(const char* name, const ThreadSettings& s, std::string& err) {
+    bool ok = true;
+    char shortName[16];
+    strncpy(shortName, name, sizeof(shortName) - 1);
+    shortName[sizeof(shortName) - 1] = '\0';
+    pthread_setname_np(pthread_self(), shortName);
+
+    if (s.cpu >= 0) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(s.cpu, &set);
+        int r = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+        if (r != 0) { err += std::string(name) + ": cpu " + strerror(r) + "; "; ok = false; }
+    }
+    if (s.fifo) {
+        sched_param sp;
+        sp.sched_priority = s.priority;
+        int r = pthread_setschedparam(pthread_self(), SCHED_FIFO, &sp);
+        if (r != 0) { err += std::string(name) + ": fifo " + strerror(r) + "; "; ok = false; }
+    } else if (s.nice != 0) {
+        // en Linux nice es por hilo (tid)
+        if (setpriority(PRIO_PROCESS, gettid(), s.nice) != 0) {
+            err += std::string(name) + ": nice " + strerror(errno) + "; ";
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+void JitterStats::reset() {
+    n = 0;
+    mean = m2 = 0.0;
+    maxNs = 0;
+    last = 0;
+}
+
+void JitterStats::tick(int64_t nowNs) {
+    if (last != 0) {
+        int64_t d = nowNs - last;
+        n++;
+        double delta = d - mean;
+        mean += delta / n;
+        m2 += delta * (d - mean);
+        if (d > maxNs) maxNs = d;
+    }
+    last = nowNs;
+}
+
+double JitterStats::stddevUs() const {
+    return n > 1 ? sqrt(m2 / (n - 1)) / 1000.0 : 0.0;
+}
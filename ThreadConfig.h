@@ -0,0 +1,77 @@
+#ifndef THREADCONFIG_H
+#define THREADCONFIG_H
+
+#include <string>
+#include <cstdint>
+#include "SoakBudget.h"
+
+// afinidad y prioridad de los hilos del juego, leidas de asteroids.conf (clave=valor):
+//
+//   sim.cpu=2          render.cpu=3        input.cpu=3
+//   sim.sched=fifo     sim.priority=10     render.nice=-5
+//   jitter_report=1    latency_report=1    latency_target_ms=50
+//   stats_report=1     event_log=events.bin    particles=512
+//   adaptive=1
+//   soak_rss_kb=65536  soak_threads=0  soak_fds=2  soak_p99_us=16500  soak_match_s=20
+//   soak_entities=4096 soak_scores_b=1024
+//
+// sim = ast-update (el tick) y los trabajadores del grafo de tareas (ast-taskN),
+// render = ast-draw y ast-hud, input = ast-input. los hilos auxiliares (ast-scores,
+// ast-snapshot, ast-spectate, ast-waves) no se tocan. sin archivo no se toca nada.
+// SCHED_FIFO y nice negativos necesitan permisos: si el sistema los niega se anota y se sigue
+
+enum ThreadGroup {
+    TG_SIM = 0,
+    TG_RENDER = 1,
+    TG_INPUT = 2,
+    TG_COUNT = 3
+};
+
+struct ThreadSettings {
+    int cpu = -1;       // -1 = cualquier nucleo
+    bool fifo = false;  // SCHED_FIFO
+    int priority = 1;   // prioridad FIFO (1..99)
+    int nice = 0;
+};
+
+struct RuntimeConfig {
+    ThreadSettings groups[TG_COUNT];
+    // reportes al terminar cada partida (debug.log): apagados salvo que asteroids.conf los pida
+    bool jitterReport = false;  // intervalos de los hilos periodicos
+    bool latencyReport = false; // histograma tecla -> pantalla
+    int latencyTargetMs = 50;
+    bool statsReport = false;   // contadores de eventos de la partida
+    std::string eventLog;      // si no esta vacio, cada evento se agrega a este archivo (binario)
+    int particleBudget = 512;  // particulas vivas como maximo (0 = sin efectos)
+    bool adaptive = true;      // degradar dibujo/simulacion bajo sobrecarga (FrameBudget)
+    SoakBudget soak;           // limites de --soak
+
+    bool load(const std::string& path); // false si no existe (se quedan los valores por defecto)
+    std::string describe() const;       // resumen de una linea para el reporte
+};
+
+// nombra el hilo que llama (pthread_setname_np, max 15 caracteres) y le aplica la
+// configuracion de su grupo. devuelve false si algo fue rechazado (detalle en err)
+bool tuneCurrentThread(const char* name, const ThreadSettings& s, std::string& err);
+
+// varianza del intervalo entre ticks de un hilo periodico (Welford, sin guardar muestras).
+// cada instancia la usa un solo hilo; se lee despues del join
+class JitterStats {
+public:
+    JitterStats() { reset(); }
+    void reset();
+    void tick(int64_t nowNs);
+
+    uint64_t count() const { return n; }
+    double meanUs() const { return mean / 1000.0; }
+    double stddevUs() const;
+    double maxUs() const { return maxNs / 1000.0; }
+
+private:
+    uint64_t n;
+    double mean, m2;
+    int64_t maxNs;
+    int64_t last;
+};
+
+#endif
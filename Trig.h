@@ -0,0 +1,54 @@
+#ifndef TRIG_H
+#define TRIG_H
+
+// tablas de direcciones de la nave, generadas en tiempo de compilacion.
+// la nave gira en pasos fijos, asi que su rumbo es un indice 0..SHIP_DIRS-1 y
+// cos/sin/glifo se leen de una tabla en vez de calcularse en cada disparo o impulso
+
+static const int SHIP_DIRS = 20;       // 18 grados por paso (~0.31 rad)
+static const int SHIP_START_DIR = 15;  // 270 grados = apuntando arriba (y crece hacia abajo)
+
+constexpr double TRIG_PI = 3.14159265358979323846;
+
+// seno por serie de Taylor; x se reduce antes a [-pi, pi] (constexpr, sin <cmath>)
+constexpr double constSin(double x) {
+    while (x > TRIG_PI) x -= 2 * TRIG_PI;
+    while (x < -TRIG_PI) x += 2 * TRIG_PI;
+    double term = x, sum = x;
+    for (int n = 1; n < 16; ++n) {
+        term *= -x * x / ((2*n) * (2*n + 1));
+        sum += term;
+    }
+    return sum;
+}
+
+constexpr double constCos(double x) {
+    return constSin(x + TRIG_PI / 2);
+}
+
+struct DirTables {
+    double cos[SHIP_DIRS];
+    double sin[SHIP_DIRS];
+    char glyph[SHIP_DIRS];
+};
+
+constexpr DirTables makeDirTables() {
+    DirTables t{};
+    for (int k = 0; k < SHIP_DIRS; ++k) {
+        double a = 2 * TRIG_PI * k / SHIP_DIRS;
+        t.cos[k] = constCos(a);
+        t.sin[k] = constSin(a);
+        // mismos sectores que el calculo original con el angulo en [-pi, pi]
+        if (a > TRIG_PI) a -= 2 * TRIG_PI;
+        double q = TRIG_PI / 4;
+        if (a >= -q && a < q) t.glyph[k] = '>';
+        else if (a >= q && a < 3*q) t.glyph[k] = 'v';
+        else if (a >= 3*q || a < -3*q) t.glyph[k] = '<';
+        else t.glyph[k] = '^';
+    }
+    return t;
+}
+
+inline constexpr DirTables DIR_TABLES = makeDirTables();
+
+#endif
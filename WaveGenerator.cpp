@@ -0,0 +1,149 @@
+#include "WaveGenerator.h"
+#include <cmath>
+#include <ctime>
+
+static const double SAFE_DX = 8.0;
+static const double SAFE_DY = 4.0;
+
+static double wrapped(double d, double size) {
+    if (d >= size/2) d -= size;
+    else if (d < -size/2) d += size;
+    return d;
+}
+
+WaveGenerator::WaveGenerator()
+: running(false), stopping(false), pending(false), ready(false),
+  count(0), worldW(1), worldH(1), rng((unsigned)time(nullptr)) {}
+
+WaveGenerator::~WaveGenerator() {
+    stop();
+}
+
+void WaveGenerator::start() {
+    if (running) return;
+    stopping = false;
+    pending = false;
+    ready = false;
+    running = true;
+    pthread_create(&worker, NULL, workerThread, this);
+}
+
+void WaveGenerator::stop() {
+    if (!running) return;
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        stopping = true;
+    }
+    cv.notify_all();
+    pthread_join(worker, NULL);
+    running = false;
+}
+
+void WaveGenerator::request(int count_, int worldW_, int worldH_, const Vec2& s1, const Vec2& s2) {
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        count = count_;
+        worldW = worldW_;
+        worldH = worldH_;
+        ship1 = s1;
+        ship2 = s2;
+        ready = false;
+        pending = true;
+    }
+    cv.notify_one();
+}
+
+bool WaveGenerator::tooClose(const Vec2& p, const Vec2& ship, int worldW, int worldH) {
+    double dx = wrapped(p.x - ship.x, worldW) / SAFE_DX;
+    double dy = wrapped(p.y - ship.y, worldH) / SAFE_DY;
+    return dx*dx + dy*dy < 1.0;
+}
+
+bool WaveGenerator::take(std::vector<Asteroid>& out, const Vec2& s1, const Vec2& s2) {
+    std::lock_guard<std::mutex> lock(mtx);
+    if (!ready) return false;
+
+    // pasada lineal: si una nave se acerco a un asteroide mientras se generaba, se lo manda
+    // al otro lado del mundo (en x, en y o en las dos). cada destino se vuelve a probar contra
+    // las dos naves; si ninguno sirve el asteroide se descarta
+    static const double SHIFTS[3][2] = { { 0.5, 0.0 }, { 0.0, 0.5 }, { 0.5, 0.5 } };
+    size_t k = 0;
+    for (size_t i = 0; i < wave.size(); ++i) {
+        Asteroid &a = wave[i];
+        bool safe = !tooClose(a.pos, s1, worldW, worldH) && !tooClose(a.pos, s2, worldW, worldH);
+        for (int t = 0; t < 3 && !safe; ++t) {
+            Vec2 p = a.pos;
+            p.x += worldW * SHIFTS[t][0];
+            p.y += worldH * SHIFTS[t][1];
+            wrapPosition(p, worldW, worldH);
+            if (tooClose(p, s1, worldW, worldH) || tooClose(p, s2, worldW, worldH)) continue;
+            a.pos = p;
+            a.prev = p;
+            safe = true;
+        }
+        if (!safe) continue;
+        if (k != i) wave[k] = wave[i];
+        k++;
+    }
+    wave.erase(wave.begin() + k, wave.end());
+
+    out.swap(wave);
+    wave.clear();
+    ready = false;
+    return true;
+}
+
+void WaveGenerator::generate() {
+    int n, w, h;
+    Vec2 s1, s2;
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        n = count; w = worldW; h = worldH;
+        s1 = ship1; s2 = ship2;
+        pending = false;
+    }
+
+    std::vector<Asteroid> next;
+    next.reserve(n);
+    std::uniform_real_distribution<double> px(4.0, w - 4.0);
+    std::uniform_real_distribution<double> py(2.0, h - 2.0);
+    std::uniform_real_distribution<double> pv(-0.8, 0.8);
+    std::uniform_int_distribution<int> big(0, 4);
+    for (int i = 0; i < n; ++i) {
+        Vec2 p;
+        // reintentar hasta quedar lejos de las naves
+        for (int tries = 0; tries < 16; ++tries) {
+            p.x = px(rng);
+            p.y = py(rng);
+            if (!tooClose(p, s1, w, h) && !tooClose(p, s2, w, h)) break;
+        }
+        double vx = pv(rng);
+        double vy = pv(rng);
+        if (fabs(vx) < 0.1) vx = 0.3;
+        if (fabs(vy) < 0.1) vy = -0.3;
+        next.emplace_back(p.x, p.y, vx, vy, big(rng) == 0 ? 3 : 2); // algunos grandes
+    }
+
+    std::lock_guard<std::mutex> lock(mtx);
+    // si llego otro pedido mientras tanto, esta oleada ya no sirve
+    if (!pending) {
+        wave.swap(next);
+        ready = true;
+    }
+}
+
+void* WaveGenerator::workerThread(void* arg) {
+    WaveGenerator* wg = (WaveGenerator*)arg;
+    pthread_setname_np(pthread_self(), "ast-waves");
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(wg->mtx);
+            wg->cv.wait(lock, [wg]{ return wg->pending || wg->stopping; });
+            if (wg->stopping) break;
+        }
+        wg->generate();
+    }
+
+    return NULL;
+}
@@ -0,0 +1,51 @@
+#ifndef WAVEGENERATOR_H
+#define WAVEGENERATOR_H
+
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <random>
+#include <pthread.h>
+#include "Asteroid.h"
+
+// prepara la siguiente oleada de asteroides en un hilo aparte, para que al limpiar el campo
+// el hilo de colisiones solo tenga que intercambiar el vector (sin el loop aleatorio adentro)
+class WaveGenerator {
+public:
+    WaveGenerator();
+    ~WaveGenerator();
+
+    void start();
+    void stop();
+
+    // pide una oleada nueva; los asteroides evitan las posiciones de las naves dadas
+    void request(int count, int worldW, int worldH, const Vec2& ship1, const Vec2& ship2);
+
+    // si la oleada pedida ya esta lista, la intercambia con out y devuelve true.
+    // las naves se mueven mientras se genera, asi que se vuelve a revisar la distancia
+    bool take(std::vector<Asteroid>& out, const Vec2& ship1, const Vec2& ship2);
+
+    // distancia minima a una nave al aparecer (elipse por las celdas de la terminal)
+    static bool tooClose(const Vec2& p, const Vec2& ship, int worldW, int worldH);
+
+private:
+    static void* workerThread(void* arg);
+    void generate();
+
+    pthread_t worker;
+    bool running;
+    bool stopping;
+    bool pending;  // hay un pedido sin atender
+    bool ready;    // wave contiene una oleada lista
+    std::mutex mtx;
+    std::condition_variable cv;
+
+    // parametros del pedido
+    int count, worldW, worldH;
+    Vec2 ship1, ship2;
+
+    std::vector<Asteroid> wave;
+    std::mt19937 rng; // rand() no es seguro entre hilos
+};
+
+#endif
@@ -1,4 +1,7 @@
 #include "Game.h"
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
 
 /*
 Universidad del Valle de Guatemala
@@ -13,8 +16,37 @@ Antony Saz 24710
 Septiembre 2025
 */
 
-int main() {
+int main(int argc, char** argv) {
     Game g;
+    // multijugador entre dos terminales: ./asteroids --host /tmp/ast.sock  y  ./asteroids --join /tmp/ast.sock
+    // espectadores: ./asteroids --spectate /tmp/ver.sock  y en otra terminal ./asteroids --watch /tmp/ver.sock
+    // prueba larga: ./asteroids --soak 2000  (sale con 2 si se paso algun limite; el debug.log queda en /tmp/asteroids-soak-*)
+    bool network = false;
+    int soakMatches = 0;
+    for (int i = 1; i < argc; ++i) {
+        if ((strcmp(argv[i], "--host") == 0 || strcmp(argv[i], "--join") == 0) && i + 1 < argc) {
+            g.setNetwork(strcmp(argv[i], "--host") == 0 ? NET_HOST : NET_JOIN, argv[i + 1]);
+            network = true;
+            ++i;
+        } else if (strcmp(argv[i], "--spectate") == 0 && i + 1 < argc) {
+            g.setSpectatorSocket(argv[++i]);
+        } else if (strcmp(argv[i], "--watch") == 0 && i + 1 < argc) {
+            return runSpectatorClient(argv[i + 1]);
+        } else if (strcmp(argv[i], "--soak") == 0 && i + 1 < argc && atoi(argv[i + 1]) > 0) {
+            soakMatches = atoi(argv[++i]);
+        } else {
+            fprintf(stderr, "uso: %s [--host <socket> | --join <socket> | --soak <partidas>] [--spectate <socket>] | --watch <socket>\n", argv[0]);
+            return 1;
+        }
+    }
+    if (soakMatches > 0 && network) {
+        fprintf(stderr, "--soak es solo local (no con --host/--join)\n");
+        return 1;
+    }
+    if (soakMatches > 0 && !g.setSoak(soakMatches)) {
+        fprintf(stderr, "--soak: no se pudo crear el directorio temporal\n");
+        return 1;
+    }
     g.run();
-    return 0;
+    return g.soakFailed() ? 2 : 0;
 }
\ No newline at end of file